@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <behema/behema.h>
+
+#define CORTEX_WIDTH 96
+#define CORTEX_HEIGHT 60
+#define NH_RADIUS 2
+#define TICKS_COUNT 120
+
+// Tells whether two neurons hold the same state.
+static int neurons_match(bhm_neuron_t* a, bhm_neuron_t* b) {
+    return a->value == b->value &&
+           a->pulse == b->pulse &&
+           a->pulse_mask == b->pulse_mask &&
+           a->synac_mask == b->synac_mask &&
+           a->synex_mask == b->synex_mask &&
+           a->syn_count == b->syn_count &&
+           a->rand_state == b->rand_state;
+}
+
+// Runs rank [rank] of a cortex partitioned among [ranks_count] processes, ticking the whole cortex alongside it
+// and checking that the rows owned by the rank match. Returns the amount of mismatching neurons, or -1 on errors.
+static int run_rank(uint32_t rank, uint32_t ranks_count, int use_shm, const char* transport_name) {
+    bhm_error_code_t error;
+
+    // Whole cortices, ticked by every rank as a reference.
+    bhm_cortex2d_t* prev_cortex;
+    bhm_cortex2d_t* next_cortex;
+    error = c2d_create(&prev_cortex, CORTEX_WIDTH, CORTEX_HEIGHT, NH_RADIUS);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error initializing the cortex %d\n", rank, error);
+        return -1;
+    }
+    error = c2d_create(&next_cortex, CORTEX_WIDTH, CORTEX_HEIGHT, NH_RADIUS);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error initializing the cortex %d\n", rank, error);
+        return -1;
+    }
+    c2d_set_evol_step(prev_cortex, 0x03U);
+    c2d_set_syngen_chance(prev_cortex, 0x4000U);
+    c2d_copy(next_cortex, prev_cortex);
+
+    // Transport and slabs.
+    bhm_transport_t* transport;
+    error = use_shm ?
+        transport_shm_create(&transport, transport_name, rank, ranks_count, BHM_DEFAULT_SHM_CAPACITY) :
+        transport_socket_create(&transport, transport_name, rank, ranks_count);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error creating the transport %d\n", rank, error);
+        return -1;
+    }
+
+    bhm_slab2d_t* prev_slab;
+    bhm_slab2d_t* next_slab;
+    error = s2d_create(&prev_slab, CORTEX_WIDTH, CORTEX_HEIGHT, NH_RADIUS, transport);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error creating the slab %d\n", rank, error);
+        return -1;
+    }
+    error = s2d_create(&next_slab, CORTEX_WIDTH, CORTEX_HEIGHT, NH_RADIUS, transport);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error creating the slab %d\n", rank, error);
+        return -1;
+    }
+    s2d_load(prev_slab, prev_cortex);
+    s2d_load(next_slab, next_cortex);
+
+    // Input spanning all slabs, with the same values on every rank.
+    bhm_input2d_t* input;
+    error = i2d_init(&input, 8, 4, CORTEX_WIDTH - 8, CORTEX_HEIGHT - 4, BHM_DEFAULT_EXC_VALUE * 2, BHM_PULSE_MAPPING_LINEAR);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error allocating input %d\n", rank, error);
+        return -1;
+    }
+    bhm_cortex_size_t input_size = (input->x1 - input->x0) * (input->y1 - input->y0);
+    uint32_t rand_state = 0x2545F491U;
+
+    // Cortex the slab's rows are stored to before comparing them.
+    bhm_cortex2d_t* gathered;
+    error = c2d_create(&gathered, CORTEX_WIDTH, CORTEX_HEIGHT, NH_RADIUS);
+    if (error != BHM_ERROR_NONE) {
+        printf("Rank %d: there was an error initializing the cortex %d\n", rank, error);
+        return -1;
+    }
+
+    int mismatches = 0;
+    for (uint32_t i = 0; i < TICKS_COUNT; i++) {
+        for (bhm_cortex_size_t j = 0; j < input_size; j++) {
+            rand_state = xorshf32(rand_state);
+            input->values[j] = rand_state % prev_cortex->sample_window;
+        }
+
+        // Feed and tick both the whole cortex and the slab.
+        c2d_feed2d(prev_cortex, input);
+        c2d_tick(prev_cortex, next_cortex);
+        s2d_feed2d(prev_slab, input);
+        error = s2d_tick(prev_slab, next_slab);
+        if (error != BHM_ERROR_NONE) {
+            printf("Rank %d: there was an error ticking the slab %d\n", rank, error);
+            return -1;
+        }
+
+        bhm_cortex2d_t* cortex = prev_cortex;
+        prev_cortex = next_cortex;
+        next_cortex = cortex;
+        bhm_slab2d_t* slab = prev_slab;
+        prev_slab = next_slab;
+        next_slab = slab;
+    }
+
+    // Compare the owned rows.
+    s2d_store(prev_slab, gathered);
+    for (bhm_cortex_size_t y = prev_slab->y0; y < prev_slab->y1; y++) {
+        for (bhm_cortex_size_t x = 0; x < CORTEX_WIDTH; x++) {
+            bhm_neuron_t expected;
+            bhm_neuron_t actual;
+            c2d_get_neuron(prev_cortex, x, y, &expected);
+            c2d_get_neuron(gathered, x, y, &actual);
+            if (!neurons_match(&expected, &actual)) {
+                mismatches++;
+            }
+        }
+    }
+    printf("Rank %d: rows %d to %d, %d mismatching neurons after %d ticks\n", rank, prev_slab->y0, prev_slab->y1, mismatches, TICKS_COUNT);
+
+    c2d_destroy(gathered);
+    i2d_destroy(input);
+    s2d_destroy(prev_slab);
+    s2d_destroy(next_slab);
+    transport_destroy(transport);
+    c2d_destroy(prev_cortex);
+    c2d_destroy(next_cortex);
+
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    uint32_t ranks_count = argc > 1 ? (uint32_t) atoi(argv[1]) : 3;
+    int use_shm = argc > 2 ? strcmp(argv[2], "socket") != 0 : 1;
+
+    if (ranks_count <= 0) {
+        printf("Usage: %s [ranks_count] [shm|socket]\n", argv[0]);
+        return 1;
+    }
+
+    // All ranks derive the transport's name from the same process id.
+    char transport_name[64];
+    snprintf(transport_name, sizeof(transport_name), use_shm ? "/bhm_partitioned_%d" : "/tmp/bhm_partitioned_%d", (int) getpid());
+    printf("Ticking a %dx%d cortex split among %d processes over %s\n", CORTEX_WIDTH, CORTEX_HEIGHT, ranks_count, use_shm ? "shared memory" : "sockets");
+    fflush(stdout);
+
+    // Each rank runs in its own process.
+    for (uint32_t rank = 0; rank < ranks_count; rank++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            printf("There was an error starting rank %d\n", rank);
+            return 1;
+        }
+        if (pid == 0) {
+            int result = run_rank(rank, ranks_count, use_shm, transport_name);
+            fflush(stdout);
+            _exit(result == 0 ? 0 : 1);
+        }
+    }
+
+    int failed_ranks = 0;
+    for (uint32_t rank = 0; rank < ranks_count; rank++) {
+        int status;
+        wait(&status);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed_ranks++;
+        }
+    }
+
+    if (failed_ranks > 0) {
+        printf("%d ranks don't match the whole cortex\n", failed_ranks);
+        return 1;
+    }
+
+    printf("All ranks match the whole cortex\n");
+    return 0;
+}
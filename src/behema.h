@@ -11,6 +11,8 @@ Copyright (C) 2021 Luka Micheletti
 
 #include "cortex.h"
 #include "population.h"
+#include "partition.h"
+#include "simulation.h"
 #include "utils.h"
 
 #ifdef __CUDACC__
@@ -1,231 +1,3153 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
 #include "behema_std.h"
+#include "behema_std_kernels.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define __BHM_X86__
+#endif
+
+// ########################################## Boundary helpers ##########################################
+
+/// @brief Resolves coordinate [coord] of a neighbor along a dimension of [size] neurons, according to the provided boundary mode.
+/// @return Whether there is a neuron at the given coordinate or not: coordinates past the edges are wrapped in torus mode and
+/// hold no neuron in open mode.
+static inline bhm_bool_t nh_resolve(bhm_boundary_mode_t boundary_mode, bhm_cortex_size_t size, bhm_cortex_size_t* coord) {
+    if (*coord >= 0 && *coord < size) {
+        return BHM_TRUE;
+    }
+    if (boundary_mode != BHM_BOUNDARY_MODE_TORUS) {
+        return BHM_FALSE;
+    }
+
+    *coord = WRAP(*coord, size);
+    return BHM_TRUE;
+}
+
+// ########################################## Fired bitmap helpers ##########################################
+
+/// @brief Updates the fired bit of the neuron at the provided coordinates after its value changed to [value].
+/// Safe to call concurrently for neurons sharing the same bitmap word.
+static inline void c2d_update_fired(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, bhm_neuron_value_t value) {
+    bhm_fired_word_t* word = &(cortex->fired.words[IDX2D(x / 64, y, cortex->fired.row_stride)]);
+    bhm_fired_word_t bit = (bhm_fired_word_t) 0x01U << (x % 64);
+
+    if (value > cortex->fire_threshold) {
+        #pragma omp atomic
+        *word |= bit;
+    } else {
+        #pragma omp atomic
+        *word &= ~bit;
+    }
+}
+
+/// @brief Computes bits [b0, b1) of fired word [w] of row [y] of the provided cortex from its neurons' values, leaving all other bits clear.
+static inline bhm_fired_word_t c2d_fired_bits(
+    const bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t w,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t b0,
+    bhm_cortex_size_t b1
+) {
+    bhm_fired_word_t word = 0x00U;
+
+    // Rows are contiguous in storage for a whole word, or for a single brick in brick layout.
+    bhm_cortex_size_t run = cortex->layout == BHM_LAYOUT_BRICK ? BHM_BRICK_SIDE : 64;
+    bhm_cortex_size_t run_count;
+    for (bhm_cortex_size_t r = b0; r < b1; r += run_count) {
+        bhm_cortex_size_t run_index = c2d_neuron_index(cortex, w * 64 + r, y);
+        run_count = b1 - r < run - r % run ? b1 - r : run - r % run;
+
+        if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+            const bhm_neuron_value_t* values = &(cortex->soa.value[run_index]);
+            for (bhm_cortex_size_t b = 0; b < run_count; b++) {
+                word |= (bhm_fired_word_t) (values[b] > cortex->fire_threshold) << (r + b);
+            }
+        } else {
+            const bhm_neuron_t* neurons = &(cortex->neurons[run_index]);
+            for (bhm_cortex_size_t b = 0; b < run_count; b++) {
+                word |= (bhm_fired_word_t) (neurons[b].value > cortex->fire_threshold) << (r + b);
+            }
+        }
+    }
+
+    return word;
+}
+
+/// @brief Rebuilds fired word [w] of row [y] of the provided cortex from its neurons' values.
+static inline void c2d_publish_fired_word(bhm_cortex2d_t* cortex, bhm_cortex_size_t w, bhm_cortex_size_t y) {
+    bhm_cortex_size_t count = cortex->width - w * 64 < 64 ? cortex->width - w * 64 : 64;
+    cortex->fired.words[IDX2D(w, y, cortex->fired.row_stride)] = c2d_fired_bits(cortex, w, y, 0, count);
+}
+
+/// @brief Rebuilds the fired bits of row [y] of the provided cortex from its neurons' values.
+static inline void c2d_publish_fired_row(bhm_cortex2d_t* cortex, bhm_cortex_size_t y) {
+    for (bhm_cortex_size_t w = 0; w < cortex->fired.row_words; w++) {
+        c2d_publish_fired_word(cortex, w, y);
+    }
+}
+
+/// @brief Rebuilds the fired bits of the neurons in [x0, x1) of row [y] of the provided cortex, only reading those neurons.
+/// Words the span covers up to the end of the row are overwritten, while words it only partly covers keep their bits out of the span:
+/// those must not be written by other threads at the same time, so spans updated concurrently should start on multiples of 64.
+static inline void c2d_publish_fired_span(bhm_cortex2d_t* cortex, bhm_cortex_size_t y, bhm_cortex_size_t x0, bhm_cortex_size_t x1) {
+    for (bhm_cortex_size_t w = x0 / 64; w * 64 < x1; w++) {
+        bhm_cortex_size_t b0 = x0 > w * 64 ? x0 - w * 64 : 0;
+        bhm_cortex_size_t b1 = x1 - w * 64 < 64 ? x1 - w * 64 : 64;
+
+        if (b0 == 0 && (b1 == 64 || x1 == cortex->width)) {
+            c2d_publish_fired_word(cortex, w, y);
+            continue;
+        }
+
+        bhm_fired_word_t mask = (((bhm_fired_word_t) 0x01U << (b1 - b0)) - 1) << b0;
+        bhm_fired_word_t* word = &(cortex->fired.words[IDX2D(w, y, cortex->fired.row_stride)]);
+        *word = (*word & ~mask) | c2d_fired_bits(cortex, w, y, b0, b1);
+    }
+}
+
+/// @brief Rebuilds the whole fired bitmap of the provided cortex if it's not valid, sharing the work among the current thread team.
+/// Must be called by all threads of the team.
+static void c2d_sync_fired_team(bhm_cortex2d_t* cortex) {
+    if (cortex->fired.valid) {
+        return;
+    }
+
+    #pragma omp for
+    for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
+        c2d_publish_fired_row(cortex, y);
+    }
+
+    #pragma omp single
+    {
+        cortex->fired.valid = BHM_TRUE;
+        cortex->fired.ghosts_valid = BHM_FALSE;
+    }
+}
+
+/// @brief Rebuilds the whole fired bitmap of the provided cortex if it's not valid.
+static void c2d_sync_fired(bhm_cortex2d_t* cortex) {
+    if (cortex->fired.valid) {
+        return;
+    }
+
+    #pragma omp parallel
+    c2d_sync_fired_team(cortex);
+}
+
+/// @brief Rebuilds the ghost border of the provided cortex' fired bitmap from its current bits, sharing the work among the current thread team.
+/// Ghost positions mirror the opposite edges in torus mode and never fire in open mode. Must be called by all threads of the team.
+static void c2d_refresh_ghosts_team(bhm_cortex2d_t* cortex) {
+    bhm_fired_bitmap_t* fired = &(cortex->fired);
+    bhm_bool_t torus = cortex->boundary_mode == BHM_BOUNDARY_MODE_TORUS;
+    bhm_cortex_size_t width = cortex->width;
+
+    // Ghost columns go first, since ghost rows are copied from whole rows.
+    #pragma omp for
+    for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
+        bhm_fired_word_t* row = &(fired->words[IDX2D(0, y, fired->row_stride)]);
+
+        // Columns past the right edge start right after the last one, in the unused bits of the last word if any.
+        row[-1] = 0x00U;
+        row[fired->row_words] = 0x00U;
+        if (width % 64 != 0) {
+            row[width / 64] &= ((bhm_fired_word_t) 0x01U << (width % 64)) - 1;
+        }
+
+        if (torus) {
+            for (bhm_cortex_size_t k = 0; k < cortex->nh_radius; k++) {
+                bhm_cortex_size_t left = WRAP(-1 - k, width);
+                bhm_cortex_size_t right = WRAP(width + k, width);
+                row[-1] |= ((row[left / 64] >> (left % 64)) & 0x01U) << (63 - k);
+                row[(width + k) / 64] |= ((row[right / 64] >> (right % 64)) & 0x01U) << ((width + k) % 64);
+            }
+        }
+    }
+
+    #pragma omp for
+    for (bhm_cortex_size_t g = 0; g < fired->ghost_rows; g++) {
+        bhm_cortex_size_t ghost_ys[2] = {-1 - g, cortex->height + g};
+
+        for (int i = 0; i < 2; i++) {
+            bhm_fired_word_t* row = &(fired->words[IDX2D(-1, ghost_ys[i], fired->row_stride)]);
+            if (torus) {
+                memcpy(row, &(fired->words[IDX2D(-1, WRAP(ghost_ys[i], cortex->height), fired->row_stride)]), fired->row_stride * sizeof(bhm_fired_word_t));
+            } else {
+                memset(row, 0x00, fired->row_stride * sizeof(bhm_fired_word_t));
+            }
+        }
+    }
+
+    #pragma omp single
+    fired->ghosts_valid = BHM_TRUE;
+}
+
+/// @brief Gathers the fired bits of the whole neighborhood of the neuron at the provided coordinates, laid out like synapse masks.
+/// Neighbors past the cortex' edges are read from the bitmap's ghost border, so it must be up to date unless the neuron is an interior one.
+static inline bhm_nh_mask_t c2d_fired_nh_mask(const bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y) {
+    bhm_cortex_size_t nh_diameter = NH_DIAM_2D(cortex->nh_radius);
+    bhm_nh_mask_t row_mask = ((bhm_nh_mask_t) 0x01U << nh_diameter) - 1;
+    // Bits are counted from the start of the left ghost word, so that they're never negative.
+    bhm_cortex_size_t first_bit = x - cortex->nh_radius + 64;
+    bhm_cortex_size_t shift = first_bit % 64;
+    bhm_nh_mask_t nh_mask = 0x00U;
+
+    for (bhm_cortex_size_t j = 0; j < nh_diameter; j++) {
+        const bhm_fired_word_t* words = &(cortex->fired.words[IDX2D(first_bit / 64 - 1, y - cortex->nh_radius + j, cortex->fired.row_stride)]);
+
+        // Neighborhood rows can span two words: the second one is always readable, thanks to the bitmap's extra word.
+        bhm_fired_word_t bits = (words[0] >> shift) | ((words[1] << 1) << (63 - shift));
+        nh_mask |= (bits & row_mask) << (j * nh_diameter);
+    }
+
+    return nh_mask;
+}
+
+// ########################################## Tile activity helpers ##########################################
+
+/// @brief Tells whether event-driven ticks can be run from the provided cortex, given its settings.
+/// Quiescent neurons are only left untouched by a tick if their random state doesn't advance and a zero value doesn't fire them.
+static inline bhm_bool_t c2d_events_enabled(const bhm_cortex2d_t* cortex) {
+    return cortex->tick_mode == BHM_TICK_MODE_EVENT &&
+           cortex->rand_mode != BHM_RAND_MODE_CONTINUOUS &&
+           cortex->fire_threshold >= 0x00;
+}
+
+/// @brief Wakes up the tile holding the neuron at the provided coordinates, after its value changed to [value].
+/// Safe to call concurrently for neurons sharing the same tile.
+static inline void c2d_wake_tile(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, bhm_neuron_value_t value) {
+    bhm_byte* flags = &(cortex->events.flags[IDX2D(x / BHM_EVENT_TILE_WIDTH, y / BHM_EVENT_TILE_HEIGHT, cortex->events.width)]);
+    bhm_byte wake_flags = value > cortex->fire_threshold ? BHM_TILE_LIVE | BHM_TILE_FIRED : BHM_TILE_LIVE;
+
+    #pragma omp atomic
+    *flags |= wake_flags;
+}
+
+/// @brief Computes the live and fired flags of the neurons in [x0, x1) x [y0, y1) of the provided cortex.
+static inline bhm_byte c2d_region_activity(
+    const bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t x0,
+    bhm_cortex_size_t y0,
+    bhm_cortex_size_t x1,
+    bhm_cortex_size_t y1
+) {
+    bhm_bool_t live = BHM_FALSE;
+    bhm_bool_t fired = BHM_FALSE;
+
+    for (bhm_cortex_size_t y = y0; y < y1; y++) {
+        for (bhm_cortex_size_t x = x0; x < x1; x++) {
+            bhm_cortex_size_t neuron_index = c2d_neuron_index(cortex, x, y);
+            bhm_neuron_value_t value;
+            bhm_pulse_mask_t pulse_mask;
+
+            if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                value = cortex->soa.value[neuron_index];
+                pulse_mask = cortex->soa.pulse_mask[neuron_index];
+            } else {
+                value = cortex->neurons[neuron_index].value;
+                pulse_mask = cortex->neurons[neuron_index].pulse_mask;
+            }
+
+            live |= (value != 0x00) | (pulse_mask != 0x00U);
+            fired |= value > cortex->fire_threshold;
+        }
+    }
+
+    return (live ? BHM_TILE_LIVE : 0x00U) | (fired ? BHM_TILE_FIRED : 0x00U);
+}
+
+/// @brief Rebuilds the live and fired flags of all tiles of the provided cortex from its neurons, sharing the work among the current thread team.
+/// Nothing is known to be clean afterwards. Must be called by all threads of the team.
+static void c2d_scan_events_team(bhm_cortex2d_t* cortex) {
+    bhm_tile_events_t* events = &(cortex->events);
+
+    #pragma omp for collapse(2)
+    for (bhm_cortex_size_t ty = 0; ty < events->height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < events->width; tx++) {
+            bhm_cortex_size_t x0 = tx * BHM_EVENT_TILE_WIDTH;
+            bhm_cortex_size_t y0 = ty * BHM_EVENT_TILE_HEIGHT;
+            bhm_cortex_size_t x1 = x0 + BHM_EVENT_TILE_WIDTH < cortex->width ? x0 + BHM_EVENT_TILE_WIDTH : cortex->width;
+            bhm_cortex_size_t y1 = y0 + BHM_EVENT_TILE_HEIGHT < cortex->height ? y0 + BHM_EVENT_TILE_HEIGHT : cortex->height;
+
+            events->flags[IDX2D(tx, ty, events->width)] = c2d_region_activity(cortex, x0, y0, x1, y1);
+        }
+    }
+
+    #pragma omp single
+    events->valid = BHM_TRUE;
+}
+
+/// @brief Rebuilds the live and fired flags of all tiles of the provided cortex from its neurons. Nothing is known to be clean afterwards.
+static void c2d_scan_events(bhm_cortex2d_t* cortex) {
+    #pragma omp parallel
+    c2d_scan_events_team(cortex);
+}
+
+/// @brief Tells whether any neuron of tile [tx, ty] of the provided cortex can change at the next tick, meaning the tile is live or has any firing neuron in its halo.
+/// Tiles are bigger than any neighborhood, so each side of the halo of a tile spans at most two tiles: the adjacent ones, or the ones at the opposite edge
+/// in torus mode, where the last tiles can be narrower than the halo. Checking the tiles holding both ends of each side is then enough.
+static inline bhm_bool_t c2d_tile_active(const bhm_cortex2d_t* cortex, bhm_cortex_size_t tx, bhm_cortex_size_t ty) {
+    const bhm_tile_events_t* events = &(cortex->events);
+    if (events->flags[IDX2D(tx, ty, events->width)] & BHM_TILE_LIVE) {
+        return BHM_TRUE;
+    }
+
+    bhm_cortex_size_t x0 = tx * BHM_EVENT_TILE_WIDTH;
+    bhm_cortex_size_t y0 = ty * BHM_EVENT_TILE_HEIGHT;
+    bhm_cortex_size_t x1 = x0 + BHM_EVENT_TILE_WIDTH < cortex->width ? x0 + BHM_EVENT_TILE_WIDTH : cortex->width;
+    bhm_cortex_size_t y1 = y0 + BHM_EVENT_TILE_HEIGHT < cortex->height ? y0 + BHM_EVENT_TILE_HEIGHT : cortex->height;
+    bhm_cortex_size_t halo_xs[5] = {x0 - cortex->nh_radius, x0 - 1, x0, x1, x1 + cortex->nh_radius - 1};
+    bhm_cortex_size_t halo_ys[5] = {y0 - cortex->nh_radius, y0 - 1, y0, y1, y1 + cortex->nh_radius - 1};
+
+    for (int j = 0; j < 5; j++) {
+        bhm_cortex_size_t y = halo_ys[j];
+        if (!nh_resolve(cortex->boundary_mode, cortex->height, &y)) {
+            continue;
+        }
+
+        for (int i = 0; i < 5; i++) {
+            bhm_cortex_size_t x = halo_xs[i];
+            if (nh_resolve(cortex->boundary_mode, cortex->width, &x) &&
+                (events->flags[IDX2D(x / BHM_EVENT_TILE_WIDTH, y / BHM_EVENT_TILE_HEIGHT, events->width)] & BHM_TILE_FIRED)) {
+                return BHM_TRUE;
+            }
+        }
+    }
+
+    return BHM_FALSE;
+}
+
+// ########################################## Input and output helpers ##########################################
+
+// Amount of pulse mappings, starting from BHM_PULSE_MAPPING_LINEAR.
+#define BHM_PULSE_MAPPINGS_COUNT 0x04U
+// Amount of 64 bits words holding the spikes of a single input over the widest sample window.
+#define BHM_PULSE_SCHEDULE_WORDS ((BHM_MAX_SAMPLE_WINDOW + 64) / 64)
+
+// Spike schedules for each pulse mapping and sample window, built the first time they're fed and kept for the whole process:
+// they only depend on the mapping and window, so all cortices share them and no setter needs to invalidate them.
+static uint64_t* pulse_schedules[BHM_PULSE_MAPPINGS_COUNT][BHM_MAX_SAMPLE_WINDOW + 1];
+
+/// @brief Returns the spike schedule of all inputs for the provided pulse mapping and sample window, building it on first use.
+/// Bit [step] of the [BHM_PULSE_SCHEDULE_WORDS] words starting at word [input * BHM_PULSE_SCHEDULE_WORDS] is set if value_to_pulse
+/// maps [input] to a spike at [step].
+/// @return The schedule, NULL if the mapping is unknown, the window is empty or wider than BHM_MAX_SAMPLE_WINDOW, or the schedule could not be allocated.
+static const uint64_t* pulse_schedule_get(bhm_pulse_mapping_t pulse_mapping, bhm_ticks_count_t sample_window) {
+    uint32_t mapping_index = (uint32_t) pulse_mapping - BHM_PULSE_MAPPING_LINEAR;
+    if (mapping_index >= BHM_PULSE_MAPPINGS_COUNT || sample_window <= 0 || sample_window > BHM_MAX_SAMPLE_WINDOW) {
+        return NULL;
+    }
+
+    uint64_t* schedule;
+
+    // Cortices fed from different threads may need the same schedule at once.
+    #pragma omp critical (bhm_pulse_schedules)
+    {
+        schedule = pulse_schedules[mapping_index][sample_window];
+        if (schedule == NULL) {
+            schedule = (uint64_t*) calloc((size_t) sample_window * BHM_PULSE_SCHEDULE_WORDS, sizeof(uint64_t));
+            if (schedule != NULL) {
+                for (bhm_ticks_count_t input = 0; input < sample_window; input++) {
+                    for (bhm_ticks_count_t step = 0; step < sample_window; step++) {
+                        if (value_to_pulse(sample_window, step, input, pulse_mapping)) {
+                            schedule[input * BHM_PULSE_SCHEDULE_WORDS + step / 64] |= (uint64_t) 0x01U << (step % 64);
+                        }
+                    }
+                }
+                pulse_schedules[mapping_index][sample_window] = schedule;
+            }
+        }
+    }
+
+    return schedule;
+}
+
+/// @brief Feeds a cortex through the provided input2d, sharing the work among the current thread team, see c2d_feed2d.
+/// Must be called by all threads of the team.
+static void c2d_feed2d_team(bhm_cortex2d_t* cortex, bhm_input2d_t* input) {
+    const bhm_ticks_count_t sample_window = cortex->sample_window;
+
+    // No input ever spikes through an empty window.
+    if (sample_window <= 0) {
+        return;
+    }
+
+    const uint64_t* schedule;
+    #pragma omp single copyprivate(schedule)
+    schedule = pulse_schedule_get(cortex->pulse_mapping, sample_window);
+
+    // All inputs are sampled at the same step, so each one's spike is a single bit of its schedule.
+    const bhm_ticks_count_t sample_step = cortex->ticks_count % sample_window;
+    const uint64_t step_bit = (uint64_t) 0x01U << (sample_step % 64);
+
+    #pragma omp for collapse(2)
+    for (bhm_cortex_size_t y = input->y0; y < input->y1; y++) {
+        for (bhm_cortex_size_t x = input->x0; x < input->x1; x++) {
+            bhm_ticks_count_t value = input->values[
+                IDX2D(
+                    x - input->x0,
+                    y - input->y0,
+                    input->x1 - input->x0
+                )
+            ];
+
+            // Check whether the current input neuron should be excited or not, computing it from scratch if no schedule is available.
+            bhm_bool_t excite;
+            if (schedule != NULL) {
+                excite = value < sample_window && (schedule[value * BHM_PULSE_SCHEDULE_WORDS + sample_step / 64] & step_bit);
+            } else {
+                excite = value_to_pulse(sample_window, sample_step, value, cortex->pulse_mapping);
+            }
+
+            if (excite) {
+                bhm_neuron_value_t* neuron_value = cortex->storage_mode == BHM_STORAGE_MODE_SOA ?
+                                                   &(cortex->soa.value[c2d_neuron_index(cortex, x, y)]) :
+                                                   &(cortex->neurons[c2d_neuron_index(cortex, x, y)].value);
+                *neuron_value += input->exc_value;
+
+                // Keep the fired bitmap in sync, so that the next tick can still read from it.
+                if (cortex->fired.valid) {
+                    c2d_update_fired(cortex, x, y, *neuron_value);
+                }
+
+                // Same for tiles activity, so that the next event-driven tick doesn't skip the neuron.
+                if (cortex->events.valid) {
+                    c2d_wake_tile(cortex, x, y, *neuron_value);
+                }
+            }
+        }
+    }
+
+    // Neurons changed, so cortices previously ticked from this one can't rely on it to skip tiles anymore.
+    #pragma omp single
+    {
+        cortex->events.version++;
+        cortex->fired.ghosts_valid = BHM_FALSE;
+    }
+}
+
+/// @brief Reads the pulses of the neurons in [x0, x1) of row [y] of the provided cortex into all outputs overlapping them.
+static inline void c2d_read_span(
+    const bhm_cortex2d_t* cortex,
+    bhm_output2d_t* const* outputs,
+    bhm_cortex_size_t outputs_count,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t x0,
+    bhm_cortex_size_t x1
+) {
+    for (bhm_cortex_size_t i = 0; i < outputs_count; i++) {
+        bhm_output2d_t* output = outputs[i];
+        if (y < output->y0 || y >= output->y1) {
+            continue;
+        }
+
+        bhm_cortex_size_t from = x0 > output->x0 ? x0 : output->x0;
+        bhm_cortex_size_t to = x1 < output->x1 ? x1 : output->x1;
+        for (bhm_cortex_size_t x = from; x < to; x++) {
+            bhm_cortex_size_t neuron_index = c2d_neuron_index(cortex, x, y);
+
+            output->values[
+                IDX2D(
+                    x - output->x0,
+                    y - output->y0,
+                    output->x1 - output->x0
+                )
+            ] = cortex->storage_mode == BHM_STORAGE_MODE_SOA ? cortex->soa.pulse[neuron_index] : cortex->neurons[neuron_index].pulse;
+        }
+    }
+}
+
+void c2d_feed2d(bhm_cortex2d_t* cortex, bhm_input2d_t* input) {
+    #pragma omp parallel
+    c2d_feed2d_team(cortex, input);
+}
+
+void c2d_read2d(bhm_cortex2d_t* cortex, bhm_output2d_t* output) {
+    #pragma omp parallel for
+    for (bhm_cortex_size_t y = output->y0; y < output->y1; y++) {
+        c2d_read_span(cortex, &output, 1, y, output->x0, output->x1);
+    }
+}
+
+
+// ########################################## Tick helpers ##########################################
+
+/// @brief Applies structural and functional plasticity to a single synapse of the neuron being updated.
+/// Kept out of line, since it only runs on evolution ticks and would otherwise bloat the integration loops.
+/// @param prev_neuron The neuron being updated, at its current state.
+/// @param next_neuron The neuron being updated, already holding any changes from previous synapses.
+/// @param neighbor_pulse The pulse of the neighbor on the other side of the synapse.
+/// @param neighbor_nh_index The index of the neighbor in the neuron's neighborhood, which is also the synapse bit in the neuron's masks.
+/// @param random The random number picked for the synapse.
+static void n2d_evolve_synapse(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    const bhm_neuron_t* prev_neuron,
+    bhm_neuron_t* next_neuron,
+    bhm_ticks_count_t neighbor_pulse,
+    bhm_cortex_size_t neighbor_nh_index,
+    bhm_chance_t random
+) {
+    const bhm_nh_mask_t syn_bit = (bhm_nh_mask_t) 0x01U << neighbor_nh_index;
+    bhm_bool_t active = (prev_neuron->synac_mask >> neighbor_nh_index) & 0x01U;
+
+    // Compute the current synapse strength.
+    bhm_syn_strength_t syn_strength = ((prev_neuron->synstr_mask_a >> neighbor_nh_index) & 0x01U) |
+                                      (((prev_neuron->synstr_mask_b >> neighbor_nh_index) & 0x01U) << 0x01U) |
+                                      (((prev_neuron->synstr_mask_c >> neighbor_nh_index) & 0x01U) << 0x02U);
+
+    // Inverse of the current synapse strength, useful when computing depression probability (synapse deletion and weakening).
+    bhm_syn_strength_t strength_diff = BHM_MAX_SYN_STRENGTH - syn_strength;
+
+    // Structural plasticity: create or destroy a synapse.
+    if (!active &&
+        prev_neuron->syn_count < next_neuron->max_syn_count &&
+        // Frequency component.
+        random < prev_cortex->syngen_chance * (bhm_chance_t) neighbor_pulse) {
+        // Add synapse.
+        next_neuron->synac_mask |= syn_bit;
+
+        // Set the new synapse's strength to 0.
+        next_neuron->synstr_mask_a &= ~syn_bit;
+        next_neuron->synstr_mask_b &= ~syn_bit;
+        next_neuron->synstr_mask_c &= ~syn_bit;
+
+        // Define whether the new synapse is excitatory or inhibitory.
+        if (random % next_cortex->inhexc_range < next_neuron->inhexc_ratio) {
+            // Inhibitory.
+            next_neuron->synex_mask &= ~syn_bit;
+        } else {
+            // Excitatory.
+            next_neuron->synex_mask |= syn_bit;
+        }
+
+        next_neuron->syn_count++;
+    } else if (active &&
+               // Only 0-strength synapses can be deleted.
+               syn_strength <= 0x00U &&
+               // Frequency component.
+               random < prev_cortex->syngen_chance / (neighbor_pulse + 1)) {
+        // Delete synapse.
+        next_neuron->synac_mask &= ~syn_bit;
+
+        next_neuron->syn_count--;
+    }
+
+    // Functional plasticity: strengthen or weaken a synapse.
+    if (active) {
+        if (syn_strength < BHM_MAX_SYN_STRENGTH &&
+            prev_neuron->tot_syn_strength < prev_cortex->max_tot_strength &&
+            random < prev_cortex->synstr_chance * (bhm_chance_t) neighbor_pulse * (bhm_chance_t) strength_diff) {
+            syn_strength++;
+            next_neuron->synstr_mask_a = (prev_neuron->synstr_mask_a & ~syn_bit) | ((bhm_nh_mask_t) (syn_strength & 0x01U) << neighbor_nh_index);
+            next_neuron->synstr_mask_b = (prev_neuron->synstr_mask_b & ~syn_bit) | ((bhm_nh_mask_t) ((syn_strength >> 0x01U) & 0x01U) << neighbor_nh_index);
+            next_neuron->synstr_mask_c = (prev_neuron->synstr_mask_c & ~syn_bit) | ((bhm_nh_mask_t) ((syn_strength >> 0x02U) & 0x01U) << neighbor_nh_index);
+
+            next_neuron->tot_syn_strength++;
+        } else if (syn_strength > 0x00U &&
+                   random < prev_cortex->synstr_chance / (neighbor_pulse + syn_strength + 1)) {
+            syn_strength--;
+            next_neuron->synstr_mask_a = (prev_neuron->synstr_mask_a & ~syn_bit) | ((bhm_nh_mask_t) (syn_strength & 0x01U) << neighbor_nh_index);
+            next_neuron->synstr_mask_b = (prev_neuron->synstr_mask_b & ~syn_bit) | ((bhm_nh_mask_t) ((syn_strength >> 0x01U) & 0x01U) << neighbor_nh_index);
+            next_neuron->synstr_mask_c = (prev_neuron->synstr_mask_c & ~syn_bit) | ((bhm_nh_mask_t) ((syn_strength >> 0x02U) & 0x01U) << neighbor_nh_index);
+
+            next_neuron->tot_syn_strength--;
+        }
+    }
+
+    // Increment evolutions count.
+    next_cortex->evols_count++;
+}
+
+/// @brief Computes the value the neuron being updated would have after integrating a firing neighbor through its synapse.
+/// @param prev_neuron The neuron being updated, at its current state.
+/// @param next_neuron The neuron being updated, already holding any changes from previous synapses.
+/// @param neighbor_nh_index The index of the neighbor in the neuron's neighborhood, which is also the synapse bit in the neuron's masks.
+static inline bhm_neuron_value_t n2d_synapse_integrated_value(
+    bhm_cortex2d_t* prev_cortex,
+    const bhm_neuron_t* prev_neuron,
+    const bhm_neuron_t* next_neuron,
+    bhm_cortex_size_t neighbor_nh_index
+) {
+    // Only bit c of the synapse strength affects the neighbor's influence.
+    bhm_syn_strength_t strength_c = (prev_neuron->synstr_mask_c >> neighbor_nh_index) & 0x01U;
+
+    bhm_neuron_value_t neighbor_influence = ((prev_neuron->synex_mask >> neighbor_nh_index) & 0x01U ? prev_cortex->exc_value : -prev_cortex->exc_value) * (strength_c + 1);
+    int integrated_value = next_neuron->value + neighbor_influence;
+
+    // Clamp to the recovery value on the way down.
+    return integrated_value < prev_cortex->recovery_value ? prev_cortex->recovery_value : integrated_value;
+}
+
+/// @brief Counts the bits set in the provided 64 bits word.
+static inline int nh_word_popcount(uint64_t word) {
+#ifdef __POPCNT__
+    return __builtin_popcountll(word);
+#else
+    // Without hardware support the builtin ends up in a library call, which is slower than counting in parallel over the word.
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int) ((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/// @brief Counts the bits set in the provided mask.
+static inline int nh_mask_popcount(bhm_nh_mask_t mask) {
+#ifdef BHM_WIDE_NH
+    return nh_word_popcount((uint64_t) mask) + nh_word_popcount((uint64_t) (mask >> 64));
+#else
+    return nh_word_popcount(mask);
+#endif
+}
+
+// 64 bits word of a neighborhood mask holding bit [index], and position of the bit within it.
+#ifdef BHM_WIDE_NH
+#define NH_MASK_WORD(index) ((index) / 64)
+#define NH_MASK_WORD_BIT(index) ((index) % 64)
+#else
+#define NH_MASK_WORD(index) 0
+#define NH_MASK_WORD_BIT(index) (index)
+#endif
+
+/// @brief Returns the index of the lowest bit set in the provided mask, which must not be empty.
+static inline bhm_cortex_size_t nh_mask_ctz(bhm_nh_mask_t mask) {
+#ifdef BHM_WIDE_NH
+    uint64_t lo = (uint64_t) mask;
+    return lo ? __builtin_ctzll(lo) : 64 + __builtin_ctzll((uint64_t) (mask >> 64));
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+#ifdef __BHM_X86__
+
+/// @brief Applies mix32_inline to 8 lanes at once.
+__attribute__((target("avx2")))
+static inline __m256i avx2_mix32(__m256i x) {
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int) 0x85EBCA6BU));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 13));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int) 0xC2B2AE35U));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    return x;
+}
+
+/// @brief Draws the counter random numbers of slots 0 to [count], rounded up to a multiple of 8, from [key] 8 slots at a time.
+__attribute__((target("avx2")))
+static void avx2_counter_randoms(uint32_t key, bhm_cortex_size_t count, bhm_rand_state_t* randoms) {
+    const __m256i golden = _mm256_set1_epi32((int) 0x9E3779B9U);
+    __m256i slots = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (bhm_cortex_size_t slot = 0; slot < count; slot += 8) {
+        __m256i counters = _mm256_add_epi32(_mm256_set1_epi32((int) key), _mm256_mullo_epi32(slots, golden));
+        _mm256_storeu_si256((__m256i*) &(randoms[slot]), avx2_mix32(counters));
+        slots = _mm256_add_epi32(slots, _mm256_set1_epi32(8));
+    }
+}
+
+#endif
+
+/// @brief Draws the random numbers of all neighborhood slots of the neuron at row major index [neuron_index] for the current tick, as defined by BHM_RAND_MODE_COUNTER.
+/// Numbers don't depend on each other, so they're all drawn at once, vectorized if possible.
+/// @param seed The neuron's random state.
+/// @param randoms The drawn numbers, indexed by neighborhood slot. Must have room for a whole 64 bits mask.
+static void c2d_counter_randoms(
+    const bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t neuron_index,
+    bhm_rand_state_t seed,
+    bhm_rand_state_t* randoms
+) {
+    uint32_t key = counter_key(seed, neuron_index, cortex->ticks_count);
+    bhm_cortex_size_t count = NH_DIAM_2D(cortex->nh_radius) * NH_DIAM_2D(cortex->nh_radius);
+
+#ifdef __BHM_X86__
+    // Slots are rounded up to a multiple of 8, which still fits a 64 bits mask: neighborhoods have at most 49 slots.
+    if (__builtin_cpu_supports("avx2")) {
+        avx2_counter_randoms(key, count, randoms);
+        return;
+    }
+#endif
+
+    for (bhm_cortex_size_t slot = 0; slot < count; slot++) {
+        randoms[slot] = counter_rand(key, slot);
+    }
+}
+
+/// @brief Computes the value the neuron being updated would have after integrating all its firing neighbors at once,
+/// as defined by BHM_INTEGRATION_MODE_POPCOUNT.
+/// @param prev_neuron The neuron being updated, at its current state.
+/// @param fired_nh_mask The neighbors over threshold, laid out like synapse masks. The central neuron's bit is ignored.
+static inline bhm_neuron_value_t n2d_popcount_integrated_value(
+    bhm_cortex2d_t* prev_cortex,
+    const bhm_neuron_t* prev_neuron,
+    bhm_nh_mask_t fired_nh_mask
+) {
+    bhm_cortex_size_t nh_diameter = NH_DIAM_2D(prev_cortex->nh_radius);
+    bhm_nh_mask_t center_mask = (bhm_nh_mask_t) 0x01U << IDX2D(prev_cortex->nh_radius, prev_cortex->nh_radius, nh_diameter);
+
+    bhm_nh_mask_t integrate_mask = prev_neuron->synac_mask & fired_nh_mask & ~center_mask;
+    bhm_nh_mask_t exc_mask = integrate_mask & prev_neuron->synex_mask;
+    bhm_nh_mask_t inh_mask = integrate_mask & ~prev_neuron->synex_mask;
+
+    // Synapses whose strength has the highest bit set weigh twice (strength / 4 + 1).
+    int exc_weight = nh_mask_popcount(exc_mask) + nh_mask_popcount(exc_mask & prev_neuron->synstr_mask_c);
+    int inh_weight = nh_mask_popcount(inh_mask) + nh_mask_popcount(inh_mask & prev_neuron->synstr_mask_c);
+    int integrated_value = prev_neuron->value + (exc_weight - inh_weight) * prev_cortex->exc_value;
+
+    // Clamp to the recovery value once, on the sum, just like sequential integration leaves the value untouched if no neighbor is integrated.
+    if (!integrate_mask) {
+        return prev_neuron->value;
+    }
+    return integrated_value < prev_cortex->recovery_value ? prev_cortex->recovery_value : integrated_value;
+}
+
+/// @brief Integrates the influence of a single neighbor into the neuron being updated, if the synapse is active and the neighbor is firing.
+/// @param prev_neuron The neuron being updated, at its current state.
+/// @param next_neuron The neuron being updated, already holding any changes from previous synapses.
+/// @param neighbor_value The value of the neighbor on the other side of the synapse.
+/// @param neighbor_nh_index The index of the neighbor in the neuron's neighborhood, which is also the synapse bit in the neuron's masks.
+static inline void n2d_integrate_synapse(
+    bhm_cortex2d_t* prev_cortex,
+    const bhm_neuron_t* prev_neuron,
+    bhm_neuron_t* next_neuron,
+    bhm_neuron_value_t neighbor_value,
+    bhm_cortex_size_t neighbor_nh_index
+) {
+    bhm_bool_t active = (prev_neuron->synac_mask >> neighbor_nh_index) & 0x01U;
+
+    // Written as a select rather than a branch, since both conditions are essentially random from neuron to neighbor.
+    bhm_bool_t integrate = active & (neighbor_value > prev_cortex->fire_threshold);
+    bhm_neuron_value_t integrated_value = n2d_synapse_integrated_value(prev_cortex, prev_neuron, next_neuron, neighbor_nh_index);
+    next_neuron->value = integrate ? integrated_value : next_neuron->value;
+}
+
+/// @brief Processes a single synapse of the neuron being updated: integrates the neighbor's influence and, if evolving, applies plasticity to the synapse.
+/// @param prev_neuron The neuron being updated, at its current state.
+/// @param next_neuron The neuron being updated, already holding any changes from previous synapses.
+/// @param neighbor_value The value of the neighbor on the other side of the synapse.
+/// @param neighbor_pulse The pulse of the neighbor on the other side of the synapse.
+/// @param neighbor_nh_index The index of the neighbor in the neuron's neighborhood, which is also the synapse bit in the neuron's masks.
+/// @param counter_randoms The random numbers drawn for each neighborhood slot, only read on evolution ticks in counter rand mode.
+/// @param fired_nh_mask The neighbors over threshold found so far, only collected in popcount integration mode, where integration is left to the caller.
+static inline void n2d_tick_synapse(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    const bhm_neuron_t* prev_neuron,
+    bhm_neuron_t* next_neuron,
+    bhm_neuron_value_t neighbor_value,
+    bhm_ticks_count_t neighbor_pulse,
+    bhm_cortex_size_t neighbor_nh_index,
+    bhm_bool_t evolve,
+    const bhm_rand_state_t* counter_randoms,
+    bhm_nh_mask_t* fired_nh_mask
+) {
+    bhm_bool_t counter_rand = prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER;
+
+    // Pick a random number for each neighbor, unless they're drawn from counters.
+    if (!counter_rand && (evolve || prev_cortex->rand_mode == BHM_RAND_MODE_CONTINUOUS)) {
+        next_neuron->rand_state = xorshf32_inline(next_neuron->rand_state);
+    }
+
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        *fired_nh_mask |= (bhm_nh_mask_t) (neighbor_value > prev_cortex->fire_threshold) << neighbor_nh_index;
+    } else {
+        n2d_integrate_synapse(prev_cortex, prev_neuron, next_neuron, neighbor_value, neighbor_nh_index);
+    }
+
+    // Perform the evolution phase if allowed, with the random number capped to the max uint16 value.
+    if (evolve) {
+        bhm_rand_state_t random = counter_rand ? counter_randoms[neighbor_nh_index] : next_neuron->rand_state;
+
+        n2d_evolve_synapse(
+            prev_cortex,
+            next_cortex,
+            prev_neuron,
+            next_neuron,
+            neighbor_pulse,
+            neighbor_nh_index,
+            random % 0xFFFFU
+        );
+    }
+}
+
+/// @brief Completes the update of a neuron once all its synapses have been processed: decay, pulse history and firing.
+/// @param prev_neuron The neuron being updated, at its current state.
+/// @param next_neuron The neuron being updated, holding the changes from all its synapses.
+static inline void n2d_tick_epilogue(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    const bhm_neuron_t* prev_neuron,
+    bhm_neuron_t* next_neuron
+) {
+    // Push to equilibrium by decaying to zero, both from above and below.
+    if (prev_neuron->value > 0x00) {
+        next_neuron->value -= next_cortex->decay_value;
+    } else if (prev_neuron->value < 0x00) {
+        next_neuron->value += next_cortex->decay_value;
+    }
+
+    if ((prev_neuron->pulse_mask >> prev_cortex->pulse_window) & 0x01U) {
+        // Decrease pulse if the oldest recorded pulse is active.
+        next_neuron->pulse--;
+    }
+
+    next_neuron->pulse_mask <<= 0x01U;
+
+    // Bring the neuron back to recovery if it just fired, otherwise fire it if its value is over its threshold.
+    if (prev_neuron->value > prev_cortex->fire_threshold + prev_neuron->pulse) {
+        // Fired at the previous step.
+        next_neuron->value = next_cortex->recovery_value;
+
+        // Store pulse.
+        next_neuron->pulse_mask |= 0x01U;
+        next_neuron->pulse++;
+    }
+}
+
+/// @brief Scatters a neuron updated by a tick to [index] of the next cortex, which is in SOA storage mode.
+/// Static state shared with the previous cortex is only written on evolution ticks, since no other tick changes it.
+/// Each neuron only ever reads its own static state, so writing it in place once the neuron is done can't affect any other neuron.
+static inline void c2d_commit_soa_neuron(
+    const bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t index,
+    const bhm_neuron_t* neuron,
+    bhm_bool_t evolve
+) {
+    if (evolve || !soa_shares_static(&(prev_cortex->soa), &(next_cortex->soa))) {
+        soa_store_static(&(next_cortex->soa), index, neuron);
+    }
+    soa_store_dynamic(&(next_cortex->soa), index, neuron);
+}
+
+
+// ########################################## Tick kernels ##########################################
+
+/// @brief Neighborhood of interior neurons, precomputed once per tick.
+/// Interior neurons have their whole neighborhood inside the cortex, so each neighbor is just a fixed offset from the neuron itself.
+typedef struct {
+    // Amount of neighbors (the central neuron is excluded).
+    bhm_cortex_size_t count;
+    // Index offset of each neighbor relative to the central neuron.
+    bhm_cortex_size_t offsets[sizeof(bhm_nh_mask_t) * 8];
+    // Index of each neighbor in the neighborhood, which is also its synapse bit in masks.
+    bhm_cortex_size_t nh_indexes[sizeof(bhm_nh_mask_t) * 8];
+    // Synapse bits of all neighbors.
+    bhm_nh_mask_t nh_mask;
+} bhm_nh_stencil_t;
+
+/// @brief Closed form of a fixed amount of xorshf32 steps.
+/// xorshf32 is linear over GF(2), so advancing a state by any amount of steps is a fixed linear map, applied one byte at a time through lookup tables.
+typedef struct {
+    uint32_t tables[4][256];
+} bhm_rand_jump_t;
+
+/// @brief Computes the lookup tables advancing a random state by [steps] xorshf32 steps at once.
+static void rand_jump_init(bhm_rand_jump_t* jump, bhm_cortex_size_t steps) {
+    for (uint32_t byte = 0; byte < 4; byte++) {
+        jump->tables[byte][0] = 0x00U;
+
+        for (uint32_t bit = 0; bit < 8; bit++) {
+            // Compute the image of the current bit, then combine it with the images of all lower bits of the byte.
+            uint32_t image = 0x01U << (byte * 8 + bit);
+            for (bhm_cortex_size_t i = 0; i < steps; i++) {
+                image = xorshf32_inline(image);
+            }
+
+            for (uint32_t lower = 0; lower < (0x01U << bit); lower++) {
+                jump->tables[byte][(0x01U << bit) | lower] = jump->tables[byte][lower] ^ image;
+            }
+        }
+    }
+}
+
+/// @brief Advances [state] by the amount of steps [jump] was computed for.
+static inline uint32_t rand_jump_apply(const bhm_rand_jump_t* jump, uint32_t state) {
+    return jump->tables[0][state & 0xFFU] ^
+           jump->tables[1][(state >> 8) & 0xFFU] ^
+           jump->tables[2][(state >> 16) & 0xFFU] ^
+           jump->tables[3][(state >> 24) & 0xFFU];
+}
+
+/// @brief Computes the interior neighborhood stencil for the provided cortex.
+static void nh_stencil_init(bhm_nh_stencil_t* stencil, bhm_cortex2d_t* cortex) {
+    bhm_cortex_size_t nh_diameter = NH_DIAM_2D(cortex->nh_radius);
+
+    stencil->count = 0;
+    stencil->nh_mask = 0x00U;
+    for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+        for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+            // Exclude the central neuron from the list of neighbors.
+            if (j != cortex->nh_radius || i != cortex->nh_radius) {
+                bhm_cortex_size_t nh_index = IDX2D(i, j, nh_diameter);
+
+                stencil->offsets[stencil->count] = IDX2D(i - cortex->nh_radius, j - cortex->nh_radius, cortex->width);
+                stencil->nh_indexes[stencil->count] = nh_index;
+                stencil->nh_mask |= (bhm_nh_mask_t) 0x01U << nh_index;
+                stencil->count++;
+            }
+        }
+    }
+}
+
+/// @brief Computes the bounds of the interior region of the provided cortex, where neurons have their whole neighborhood inside the cortex.
+/// Everything outside [x0, x1) x [y0, y1) is border. Bounds are always ordered, even when the cortex is too small to have an interior.
+static void c2d_interior_bounds(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t* x0,
+    bhm_cortex_size_t* y0,
+    bhm_cortex_size_t* x1,
+    bhm_cortex_size_t* y1
+) {
+    *x0 = cortex->nh_radius < cortex->width ? cortex->nh_radius : cortex->width;
+    *y0 = cortex->nh_radius < cortex->height ? cortex->nh_radius : cortex->height;
+    *x1 = cortex->width - cortex->nh_radius > *x0 ? cortex->width - cortex->nh_radius : *x0;
+    *y1 = cortex->height - cortex->nh_radius > *y0 ? cortex->height - cortex->nh_radius : *y0;
+}
+
+/// @brief Updates the neuron at the provided coordinates of a cortex in AOS storage mode.
+/// Works anywhere in the cortex, neighbors past its edges are wrapped or skipped according to its boundary mode.
+static inline void c2d_tick_aos_neuron(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_bool_t evolve
+) {
+    /* Compute the neighborhood diameter:
+           d = 7
+      <------------->
+       r = 3
+      <----->
+      +-|-|-|-|-|-|-+
+      |             |
+      |             |
+      |      X      |
+      |             |
+      |             |
+      +-|-|-|-|-|-|-+
+    */
+    bhm_cortex_size_t nh_diameter = NH_DIAM_2D(prev_cortex->nh_radius);
+
+    // Retrieve the involved neurons.
+    bhm_cortex_size_t neuron_index = c2d_neuron_index(prev_cortex, x, y);
+    bhm_neuron_t prev_neuron = prev_cortex->neurons[neuron_index];
+    bhm_neuron_t* next_neuron = &(next_cortex->neurons[neuron_index]);
+
+    // Copy prev neuron values to the new one.
+    *next_neuron = prev_neuron;
+
+    // Draw all random numbers at once if they don't depend on each other.
+    // Streams are keyed by the neuron's row major index, so that they don't depend on the cortex' layout.
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8];
+    if (evolve && prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER) {
+        c2d_counter_randoms(prev_cortex, IDX2D(x, y, prev_cortex->width), prev_neuron.rand_state, counter_randoms);
+    }
+
+    // Increment the current neuron value by reading its connected neighbors.
+    bhm_nh_mask_t fired_nh_mask = 0x00U;
+    for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+        for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+            bhm_cortex_size_t neighbor_x = x + (i - prev_cortex->nh_radius);
+            bhm_cortex_size_t neighbor_y = y + (j - prev_cortex->nh_radius);
+
+            // Exclude the central neuron from the list of neighbors, along with neighbors past open edges.
+            if ((j != prev_cortex->nh_radius || i != prev_cortex->nh_radius) &&
+                nh_resolve(prev_cortex->boundary_mode, prev_cortex->width, &neighbor_x) &&
+                nh_resolve(prev_cortex->boundary_mode, prev_cortex->height, &neighbor_y)) {
+                bhm_cortex_size_t neighbor_index = c2d_neuron_index(prev_cortex, neighbor_x, neighbor_y);
+
+                // Only the neighbor's value and pulse are needed.
+                n2d_tick_synapse(
+                    prev_cortex,
+                    next_cortex,
+                    &prev_neuron,
+                    next_neuron,
+                    prev_cortex->neurons[neighbor_index].value,
+                    prev_cortex->neurons[neighbor_index].pulse,
+                    IDX2D(i, j, nh_diameter),
+                    evolve,
+                    counter_randoms,
+                    &fired_nh_mask
+                );
+            }
+        }
+    }
+
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron->value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask);
+    }
+
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, next_neuron);
+}
+
+/// @brief Updates the interior neuron at [neuron_index] of a cortex in AOS storage mode.
+/// No bounds are checked: the neighborhood is walked through the provided stencil.
+static inline void c2d_tick_aos_interior_neuron(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t neuron_index,
+    const bhm_nh_stencil_t* stencil,
+    bhm_bool_t evolve
+) {
+    bhm_neuron_t prev_neuron = prev_cortex->neurons[neuron_index];
+    bhm_neuron_t* next_neuron = &(next_cortex->neurons[neuron_index]);
+    const bhm_neuron_t* neighbors = &(prev_cortex->neurons[neuron_index]);
+
+    *next_neuron = prev_neuron;
+
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8];
+    if (evolve && prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER) {
+        c2d_counter_randoms(prev_cortex, neuron_index, prev_neuron.rand_state, counter_randoms);
+    }
+
+    bhm_nh_mask_t fired_nh_mask = 0x00U;
+    for (bhm_cortex_size_t k = 0; k < stencil->count; k++) {
+        n2d_tick_synapse(
+            prev_cortex,
+            next_cortex,
+            &prev_neuron,
+            next_neuron,
+            neighbors[stencil->offsets[k]].value,
+            neighbors[stencil->offsets[k]].pulse,
+            stencil->nh_indexes[k],
+            evolve,
+            counter_randoms,
+            &fired_nh_mask
+        );
+    }
+
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron->value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask);
+    }
+
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, next_neuron);
+}
+
+/// @brief Updates the interior neuron at the provided coordinates of a cortex in AOS storage mode on a non-evolution tick.
+/// Neighbors' firing state is read from the previous cortex' fired bitmap, so that only synapses actually integrating are visited,
+/// in the same order as a full neighborhood walk: results match the other kernels exactly.
+/// @param rand_jump The closed form of the neuron's random state advance over the whole neighborhood, NULL if random states should be left untouched.
+static inline void c2d_tick_aos_integrate_neuron(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    const bhm_nh_stencil_t* stencil,
+    const bhm_rand_jump_t* rand_jump
+) {
+    bhm_cortex_size_t neuron_index = c2d_neuron_index(prev_cortex, x, y);
+
+    bhm_neuron_t prev_neuron = prev_cortex->neurons[neuron_index];
+    bhm_neuron_t* next_neuron = &(next_cortex->neurons[neuron_index]);
+
+    *next_neuron = prev_neuron;
+
+    bhm_nh_mask_t fired_nh_mask = c2d_fired_nh_mask(prev_cortex, x, y);
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron->value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask);
+    } else {
+        for (bhm_nh_mask_t integrate_mask = prev_neuron.synac_mask & stencil->nh_mask & fired_nh_mask; integrate_mask; integrate_mask &= integrate_mask - 1) {
+            next_neuron->value = n2d_synapse_integrated_value(prev_cortex, &prev_neuron, next_neuron, nh_mask_ctz(integrate_mask));
+        }
+    }
+
+    if (rand_jump != NULL) {
+        next_neuron->rand_state = rand_jump_apply(rand_jump, next_neuron->rand_state);
+    }
+
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, next_neuron);
+}
+
+// Radius-specialized interior kernels, see behema_std_kernels.h.
+BHM_DEFINE_INTERIOR_KERNELS(1)
+BHM_DEFINE_INTERIOR_KERNELS(2)
+BHM_DEFINE_INTERIOR_KERNELS(3)
+#ifdef BHM_WIDE_NH
+BHM_DEFINE_INTERIOR_KERNELS(4)
+BHM_DEFINE_INTERIOR_KERNELS(5)
+#endif
+
+/// @brief Updates the interior neurons in [x0, x1) of row [y] of a cortex in AOS storage mode.
+/// Non-evolution ticks only integrate active synapses. On evolution ticks radii 1 to 3 (up to 5 with wide masks) are handled by specialized kernels,
+/// any other radius falls back to the provided stencil.
+/// @param rand_jump The random state advance used on non-evolution ticks, NULL if random states should be left untouched.
+static inline void c2d_tick_aos_interior_row(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t x0,
+    bhm_cortex_size_t x1,
+    const bhm_nh_stencil_t* stencil,
+    const bhm_rand_jump_t* rand_jump,
+    bhm_bool_t evolve
+) {
+    bhm_cortex_size_t row_index = IDX2D(0, y, prev_cortex->width);
+
+    if (!evolve) {
+        for (bhm_cortex_size_t x = x0; x < x1; x++) {
+            c2d_tick_aos_integrate_neuron(prev_cortex, next_cortex, x, y, stencil, rand_jump);
+        }
+        return;
+    }
+
+    // Neighbors are only a fixed offset apart in row major layout.
+    if (prev_cortex->layout != BHM_LAYOUT_ROW_MAJOR) {
+        for (bhm_cortex_size_t x = x0; x < x1; x++) {
+            c2d_tick_aos_neuron(prev_cortex, next_cortex, x, y, evolve);
+        }
+        return;
+    }
+
+    switch (prev_cortex->nh_radius) {
+        case 1:
+            c2d_tick_aos_interior_row_r1(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+        case 2:
+            c2d_tick_aos_interior_row_r2(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+        case 3:
+            c2d_tick_aos_interior_row_r3(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+#ifdef BHM_WIDE_NH
+        case 4:
+            c2d_tick_aos_interior_row_r4(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+        case 5:
+            c2d_tick_aos_interior_row_r5(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+#endif
+        default:
+            for (bhm_cortex_size_t x = x0; x < x1; x++) {
+                c2d_tick_aos_interior_neuron(prev_cortex, next_cortex, row_index + x, stencil, evolve);
+            }
+            break;
+    }
+}
+
+/// @brief Updates the neuron at the provided coordinates of a cortex in SOA storage mode.
+/// Works anywhere in the cortex, neighbors past its edges are wrapped or skipped according to its boundary mode.
+/// Neighbors are read from the value and pulse arrays only, so each neighbor visit touches 4 bytes instead of a whole neuron.
+static inline void c2d_tick_soa_neuron(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_bool_t evolve
+) {
+    bhm_cortex_size_t nh_diameter = NH_DIAM_2D(prev_cortex->nh_radius);
+    bhm_cortex_size_t neuron_index = c2d_neuron_index(prev_cortex, x, y);
+
+    // Gather the involved neuron, working on local copies.
+    bhm_neuron_t prev_neuron;
+    soa_load_neuron(&(prev_cortex->soa), neuron_index, &prev_neuron);
+    bhm_neuron_t next_neuron = prev_neuron;
+
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8];
+    if (evolve && prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER) {
+        c2d_counter_randoms(prev_cortex, IDX2D(x, y, prev_cortex->width), prev_neuron.rand_state, counter_randoms);
+    }
+
+    bhm_nh_mask_t fired_nh_mask = 0x00U;
+    for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+        for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+            bhm_cortex_size_t neighbor_x = x + (i - prev_cortex->nh_radius);
+            bhm_cortex_size_t neighbor_y = y + (j - prev_cortex->nh_radius);
+
+            // Exclude the central neuron from the list of neighbors, along with neighbors past open edges.
+            if ((j != prev_cortex->nh_radius || i != prev_cortex->nh_radius) &&
+                nh_resolve(prev_cortex->boundary_mode, prev_cortex->width, &neighbor_x) &&
+                nh_resolve(prev_cortex->boundary_mode, prev_cortex->height, &neighbor_y)) {
+                bhm_cortex_size_t neighbor_index = c2d_neuron_index(prev_cortex, neighbor_x, neighbor_y);
+
+                n2d_tick_synapse(
+                    prev_cortex,
+                    next_cortex,
+                    &prev_neuron,
+                    &next_neuron,
+                    prev_cortex->soa.value[neighbor_index],
+                    prev_cortex->soa.pulse[neighbor_index],
+                    IDX2D(i, j, nh_diameter),
+                    evolve,
+                    counter_randoms,
+                    &fired_nh_mask
+                );
+            }
+        }
+    }
+
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron.value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask);
+    }
+
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, &next_neuron);
+
+    // Scatter the updated neuron back.
+    c2d_commit_soa_neuron(prev_cortex, next_cortex, neuron_index, &next_neuron, evolve);
+}
+
+/// @brief Updates the interior neuron at [neuron_index] of a cortex in SOA storage mode.
+/// No bounds are checked: the neighborhood is walked through the provided stencil.
+static inline void c2d_tick_soa_interior_neuron(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t neuron_index,
+    const bhm_nh_stencil_t* stencil,
+    bhm_bool_t evolve
+) {
+    const bhm_neuron_value_t* neighbor_values = &(prev_cortex->soa.value[neuron_index]);
+    const bhm_ticks_count_t* neighbor_pulses = &(prev_cortex->soa.pulse[neuron_index]);
+
+    bhm_neuron_t prev_neuron;
+    soa_load_neuron(&(prev_cortex->soa), neuron_index, &prev_neuron);
+    bhm_neuron_t next_neuron = prev_neuron;
+
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8];
+    if (evolve && prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER) {
+        c2d_counter_randoms(prev_cortex, neuron_index, prev_neuron.rand_state, counter_randoms);
+    }
+
+    bhm_nh_mask_t fired_nh_mask = 0x00U;
+    for (bhm_cortex_size_t k = 0; k < stencil->count; k++) {
+        n2d_tick_synapse(
+            prev_cortex,
+            next_cortex,
+            &prev_neuron,
+            &next_neuron,
+            neighbor_values[stencil->offsets[k]],
+            neighbor_pulses[stencil->offsets[k]],
+            stencil->nh_indexes[k],
+            evolve,
+            counter_randoms,
+            &fired_nh_mask
+        );
+    }
+
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron.value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask);
+    }
+
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, &next_neuron);
+
+    c2d_commit_soa_neuron(prev_cortex, next_cortex, neuron_index, &next_neuron, evolve);
+}
+
+/// @brief Updates the interior neuron at the provided coordinates of a cortex in SOA storage mode on a non-evolution tick.
+/// Neighbors' firing state is read from the previous cortex' fired bitmap, so that only synapses actually integrating are visited,
+/// in the same order as a full neighborhood walk: results match the other kernels exactly.
+/// @param rand_jump The closed form of the neuron's random state advance over the whole neighborhood, NULL if random states should be left untouched.
+static inline void c2d_tick_soa_integrate_neuron(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    const bhm_nh_stencil_t* stencil,
+    const bhm_rand_jump_t* rand_jump
+) {
+    bhm_cortex_size_t neuron_index = c2d_neuron_index(prev_cortex, x, y);
+
+    bhm_neuron_t prev_neuron;
+    soa_load_neuron(&(prev_cortex->soa), neuron_index, &prev_neuron);
+    bhm_neuron_t next_neuron = prev_neuron;
+
+    bhm_nh_mask_t fired_nh_mask = c2d_fired_nh_mask(prev_cortex, x, y);
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron.value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask);
+    } else {
+        for (bhm_nh_mask_t integrate_mask = prev_neuron.synac_mask & stencil->nh_mask & fired_nh_mask; integrate_mask; integrate_mask &= integrate_mask - 1) {
+            next_neuron.value = n2d_synapse_integrated_value(prev_cortex, &prev_neuron, &next_neuron, nh_mask_ctz(integrate_mask));
+        }
+    }
+
+    if (rand_jump != NULL) {
+        next_neuron.rand_state = rand_jump_apply(rand_jump, next_neuron.rand_state);
+    }
+
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, &next_neuron);
+
+    c2d_commit_soa_neuron(prev_cortex, next_cortex, neuron_index, &next_neuron, BHM_FALSE);
+}
+
+/// @brief Updates the interior neurons in [x0, x1) of row [y] of a cortex in SOA storage mode.
+/// Non-evolution ticks only integrate active synapses. On evolution ticks radii 1 to 3 (up to 5 with wide masks) are handled by specialized kernels,
+/// any other radius falls back to the provided stencil.
+/// @param rand_jump The random state advance used on non-evolution ticks, NULL if random states should be left untouched.
+static inline void c2d_tick_soa_interior_row(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t x0,
+    bhm_cortex_size_t x1,
+    const bhm_nh_stencil_t* stencil,
+    const bhm_rand_jump_t* rand_jump,
+    bhm_bool_t evolve
+) {
+    bhm_cortex_size_t row_index = IDX2D(0, y, prev_cortex->width);
+
+    if (!evolve) {
+        for (bhm_cortex_size_t x = x0; x < x1; x++) {
+            c2d_tick_soa_integrate_neuron(prev_cortex, next_cortex, x, y, stencil, rand_jump);
+        }
+        return;
+    }
+
+    // Neighbors are only a fixed offset apart in row major layout.
+    if (prev_cortex->layout != BHM_LAYOUT_ROW_MAJOR) {
+        for (bhm_cortex_size_t x = x0; x < x1; x++) {
+            c2d_tick_soa_neuron(prev_cortex, next_cortex, x, y, evolve);
+        }
+        return;
+    }
+
+    switch (prev_cortex->nh_radius) {
+        case 1:
+            c2d_tick_soa_interior_row_r1(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+        case 2:
+            c2d_tick_soa_interior_row_r2(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+        case 3:
+            c2d_tick_soa_interior_row_r3(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+#ifdef BHM_WIDE_NH
+        case 4:
+            c2d_tick_soa_interior_row_r4(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+        case 5:
+            c2d_tick_soa_interior_row_r5(prev_cortex, next_cortex, row_index, x0, x1);
+            break;
+#endif
+        default:
+            for (bhm_cortex_size_t x = x0; x < x1; x++) {
+                c2d_tick_soa_interior_neuron(prev_cortex, next_cortex, row_index + x, stencil, evolve);
+            }
+            break;
+    }
+}
+
+/// @brief Updates the neurons in [xa, xb) of row [y] of a cortex, whatever its storage mode,
+/// running interior neurons through the interior kernels and all others through the bounds-checked one.
+/// @param rand_jump The random state advance used on non-evolution ticks, NULL if random states should be left untouched.
+static inline void c2d_tick_span(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t xa,
+    bhm_cortex_size_t xb,
+    const bhm_nh_stencil_t* stencil,
+    const bhm_rand_jump_t* rand_jump,
+    bhm_bool_t evolve
+) {
+    bhm_bool_t soa = prev_cortex->storage_mode == BHM_STORAGE_MODE_SOA;
+
+    // Non-evolution ticks read neighbors' firing state through the fired bitmap, whose ghost border stands in for positions past the edges,
+    // so border neurons can go through the same kernel as interior ones. Unless random states advance by the amount of neighbors actually visited,
+    // which is smaller at open edges.
+    if (!evolve && prev_cortex->fired.ghosts_valid && (rand_jump == NULL || prev_cortex->boundary_mode == BHM_BOUNDARY_MODE_TORUS)) {
+        if (soa) {
+            for (bhm_cortex_size_t x = xa; x < xb; x++) {
+                c2d_tick_soa_integrate_neuron(prev_cortex, next_cortex, x, y, stencil, rand_jump);
+            }
+        } else {
+            for (bhm_cortex_size_t x = xa; x < xb; x++) {
+                c2d_tick_aos_integrate_neuron(prev_cortex, next_cortex, x, y, stencil, rand_jump);
+            }
+        }
+        return;
+    }
+
+    bhm_cortex_size_t x0, y0, x1, y1;
+    c2d_interior_bounds(prev_cortex, &x0, &y0, &x1, &y1);
+
+    // Restrict the interior to the span, border rows have no interior at all.
+    bhm_cortex_size_t ia = y < y0 || y >= y1 ? xb : (x0 > xa ? (x0 < xb ? x0 : xb) : xa);
+    bhm_cortex_size_t ib = y < y0 || y >= y1 ? xb : (x1 < xb ? (x1 > ia ? x1 : ia) : xb);
+
+    if (soa) {
+        for (bhm_cortex_size_t x = xa; x < ia; x++) {
+            c2d_tick_soa_neuron(prev_cortex, next_cortex, x, y, evolve);
+        }
+        c2d_tick_soa_interior_row(prev_cortex, next_cortex, y, ia, ib, stencil, rand_jump, evolve);
+        for (bhm_cortex_size_t x = ib; x < xb; x++) {
+            c2d_tick_soa_neuron(prev_cortex, next_cortex, x, y, evolve);
+        }
+    } else {
+        for (bhm_cortex_size_t x = xa; x < ia; x++) {
+            c2d_tick_aos_neuron(prev_cortex, next_cortex, x, y, evolve);
+        }
+        c2d_tick_aos_interior_row(prev_cortex, next_cortex, y, ia, ib, stencil, rand_jump, evolve);
+        for (bhm_cortex_size_t x = ib; x < xb; x++) {
+            c2d_tick_aos_neuron(prev_cortex, next_cortex, x, y, evolve);
+        }
+    }
+}
+
+/// @brief Scalar tick kernel for cortices in either storage mode. Must be called by all threads of the current team.
+static void c2d_tick_tiles(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_bool_t evolve,
+    bhm_output2d_t* const* outputs,
+    bhm_cortex_size_t outputs_count
+) {
+    bhm_nh_stencil_t stencil;
+    nh_stencil_init(&stencil, prev_cortex);
+
+    // Random states jump over the whole neighborhood at once on non-evolution ticks, if they advance at all.
+    bhm_rand_jump_t rand_jump;
+    bhm_bool_t jump_rand = !evolve && prev_cortex->rand_mode == BHM_RAND_MODE_CONTINUOUS;
+    if (jump_rand) {
+        rand_jump_init(&rand_jump, stencil.count);
+    }
+
+    bhm_cortex_size_t tiles_width, tiles_height;
+    c2d_tiles_count(prev_cortex, &tiles_width, &tiles_height);
+
+    // Threads own whole tiles, statically scheduled so that each one gets a contiguous run of them.
+    #pragma omp for collapse(2) schedule(static)
+    for (bhm_cortex_size_t ty = 0; ty < tiles_height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < tiles_width; tx++) {
+            bhm_cortex_size_t x0, y0, x1, y1;
+            c2d_tile_bounds(prev_cortex, tx, ty, &x0, &y0, &x1, &y1);
+
+            for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                c2d_tick_span(prev_cortex, next_cortex, y, x0, x1, &stencil, jump_rand ? &rand_jump : NULL, evolve);
+
+                // Publish the row and read outputs from it while it's still in cache.
+                c2d_publish_fired_span(next_cortex, y, x0, x1);
+                c2d_read_span(next_cortex, outputs, outputs_count, y, x0, x1);
+            }
+        }
+    }
+}
+
+/// @brief Event-driven non-evolution tick kernel, see BHM_TICK_MODE_EVENT.
+/// Only tiles that are active in the previous cortex are updated, using the same kernels as full ticks.
+/// The previous cortex' tiles activity must be valid, and its random states must not advance.
+/// Must be called by all threads of the current team.
+static void c2d_tick_events(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_output2d_t* const* outputs,
+    bhm_cortex_size_t outputs_count
+) {
+    bhm_nh_stencil_t stencil;
+    nh_stencil_init(&stencil, prev_cortex);
+
+    const bhm_tile_events_t* prev_events = &(prev_cortex->events);
+    bhm_tile_events_t* next_events = &(next_cortex->events);
+
+    // Quiescent tiles can only be skipped if the next cortex already holds them, which is known for clean tiles
+    // as long as the next cortex is still the one the previous one was ticked from.
+    bhm_bool_t synced = prev_events->source == next_cortex && prev_events->source_version == next_events->version;
+
+    #pragma omp for collapse(2) schedule(dynamic)
+    for (bhm_cortex_size_t ty = 0; ty < prev_events->height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < prev_events->width; tx++) {
+            bhm_cortex_size_t tile_index = IDX2D(tx, ty, prev_events->width);
+            bhm_cortex_size_t x0 = tx * BHM_EVENT_TILE_WIDTH;
+            bhm_cortex_size_t y0 = ty * BHM_EVENT_TILE_HEIGHT;
+            bhm_cortex_size_t x1 = x0 + BHM_EVENT_TILE_WIDTH < prev_cortex->width ? x0 + BHM_EVENT_TILE_WIDTH : prev_cortex->width;
+            bhm_cortex_size_t y1 = y0 + BHM_EVENT_TILE_HEIGHT < prev_cortex->height ? y0 + BHM_EVENT_TILE_HEIGHT : prev_cortex->height;
+            bhm_bool_t active = c2d_tile_active(prev_cortex, tx, ty);
+
+            if (!active && synced && (prev_events->flags[tile_index] & BHM_TILE_CLEAN)) {
+                // Skipped tiles have no neuron over threshold, since they're not live.
+                for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                    next_cortex->fired.words[IDX2D(tx, y, next_cortex->fired.row_stride)] = 0x00U;
+                    c2d_read_span(next_cortex, outputs, outputs_count, y, x0, x1);
+                }
+                next_events->flags[tile_index] = BHM_TILE_CLEAN;
+                continue;
+            }
+
+            for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                c2d_tick_span(prev_cortex, next_cortex, y, x0, x1, &stencil, NULL, BHM_FALSE);
+
+                // Tiles are exactly one word wide.
+                c2d_publish_fired_word(next_cortex, tx, y);
+                c2d_read_span(next_cortex, outputs, outputs_count, y, x0, x1);
+            }
+
+            // Inactive tiles come out of the tick unchanged, so they're clean from now on.
+            next_events->flags[tile_index] = c2d_region_activity(next_cortex, x0, y0, x1, y1) | (active ? 0x00U : BHM_TILE_CLEAN);
+        }
+    }
+
+    #pragma omp single
+    next_events->valid = BHM_TRUE;
+}
+
+/// @brief Completes a non-evolution update of [count] consecutive neurons of a cortex in SOA storage mode, starting from [neuron_index].
+/// Used by vectorized kernels once their neurons' values and random states have been computed for all neighbors.
+/// @param values The values of the neurons after integration, one per neuron.
+/// @param rand_states The random states of the neurons after integration, one per neuron.
+static inline void c2d_tick_soa_lanes_epilogue(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t neuron_index,
+    bhm_cortex_size_t count,
+    const int32_t* values,
+    const uint32_t* rand_states
+) {
+    const bhm_neurons_soa_t* prev_soa = &(prev_cortex->soa);
+    bhm_neurons_soa_t* next_soa = &(next_cortex->soa);
+    bhm_bool_t copy_static = !soa_shares_static(prev_soa, next_soa);
+
+    for (bhm_cortex_size_t l = 0; l < count; l++) {
+        bhm_cortex_size_t index = neuron_index + l;
+
+        // Only the properties touched by the epilogue are needed.
+        bhm_neuron_t prev_neuron = {
+            .value = prev_soa->value[index],
+            .pulse = prev_soa->pulse[index],
+            .pulse_mask = prev_soa->pulse_mask[index]
+        };
+        bhm_neuron_t next_neuron = prev_neuron;
+        next_neuron.value = (bhm_neuron_value_t) values[l];
+
+        n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, &next_neuron);
+
+        next_soa->value[index] = next_neuron.value;
+        next_soa->pulse[index] = next_neuron.pulse;
+        next_soa->pulse_mask[index] = next_neuron.pulse_mask;
+        next_soa->rand_state[index] = rand_states[l];
+
+        // Synapses are left untouched outside of evolution ticks, so there's nothing to copy if they're shared.
+        if (copy_static) {
+            next_soa->synac_mask[index] = prev_soa->synac_mask[index];
+            next_soa->synex_mask[index] = prev_soa->synex_mask[index];
+            next_soa->synstr_mask_a[index] = prev_soa->synstr_mask_a[index];
+            next_soa->synstr_mask_b[index] = prev_soa->synstr_mask_b[index];
+            next_soa->synstr_mask_c[index] = prev_soa->synstr_mask_c[index];
+            next_soa->max_syn_count[index] = prev_soa->max_syn_count[index];
+            next_soa->syn_count[index] = prev_soa->syn_count[index];
+            next_soa->tot_syn_strength[index] = prev_soa->tot_syn_strength[index];
+            next_soa->inhexc_ratio[index] = prev_soa->inhexc_ratio[index];
+        }
+    }
+}
+
+#ifdef __BHM_X86__
+
+/// @brief Expands the lowest 8 bits of [bits] to 8 32-bit lanes, each one set to all ones if its bit is set and to all zeros otherwise.
+__attribute__((target("avx2")))
+static inline __m256i avx2_expand_bits(uint32_t bits) {
+    const __m256i lane_bits = _mm256_setr_epi32(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(bits), lane_bits), lane_bits);
+}
+
+/// @brief Extracts bit [bit] from 8 64-bit masks, stored 4 in [lo] and 4 in [hi], and packs them in the lowest 8 bits of the result.
+__attribute__((target("avx2")))
+static inline uint32_t avx2_mask_bits(__m256i lo, __m256i hi, bhm_cortex_size_t bit) {
+    __m128i shift = _mm_cvtsi32_si128(63 - bit);
+    return (uint32_t) _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_sll_epi64(lo, shift))) |
+           ((uint32_t) _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_sll_epi64(hi, shift))) << 4);
+}
+
+/// @brief Loads the 8 masks starting at [masks], 4 in [lo] and 4 in [hi], one vector per 64 bits word of theirs.
+/// Wide masks are transposed so that each vector holds the same word of 4 masks, ready for avx2_mask_bits.
+__attribute__((target("avx2")))
+static inline void avx2_load_masks(const bhm_nh_mask_t* masks, __m256i lo[BHM_NH_MASK_WORDS], __m256i hi[BHM_NH_MASK_WORDS]) {
+#ifdef BHM_WIDE_NH
+    // Each load holds 2 whole masks: unpacking gathers their words in mask order 0 2 1 3, which the permutation then fixes.
+    __m256i lo_a = _mm256_loadu_si256((const __m256i*) &(masks[0]));
+    __m256i lo_b = _mm256_loadu_si256((const __m256i*) &(masks[2]));
+    __m256i hi_a = _mm256_loadu_si256((const __m256i*) &(masks[4]));
+    __m256i hi_b = _mm256_loadu_si256((const __m256i*) &(masks[6]));
+    lo[0] = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(lo_a, lo_b), 0xD8);
+    lo[1] = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(lo_a, lo_b), 0xD8);
+    hi[0] = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(hi_a, hi_b), 0xD8);
+    hi[1] = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(hi_a, hi_b), 0xD8);
+#else
+    lo[0] = _mm256_loadu_si256((const __m256i*) &(masks[0]));
+    hi[0] = _mm256_loadu_si256((const __m256i*) &(masks[4]));
+#endif
+}
+
+/// @brief Advances 8 xorshf32 random states at once.
+__attribute__((target("avx2")))
+static inline __m256i avx2_xorshf32(__m256i state) {
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+    state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+    state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+    return state;
+}
+
+/// @brief Wraps each 32-bit lane to the 16-bit range, just like storing it to a bhm_neuron_value_t would.
+__attribute__((target("avx2")))
+static inline __m256i avx2_wrap16(__m256i values) {
+    return _mm256_srai_epi32(_mm256_slli_epi32(values, 16), 16);
+}
+
+/// @brief Non-evolution update of the neurons in [xa, xb) of row [y] of a cortex in SOA storage mode, 8 horizontally adjacent neurons at a time using AVX2.
+/// Values are integrated in 32-bit lanes and wrapped back to 16 bits after each neighbor, which matches the scalar kernel bit for bit.
+__attribute__((target("avx2")))
+static void c2d_tick_soa_avx2_span(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t xa,
+    bhm_cortex_size_t xb
+) {
+    const bhm_cortex_size_t width = prev_cortex->width;
+    const bhm_nh_radius_t nh_radius = prev_cortex->nh_radius;
+    const bhm_cortex_size_t nh_diameter = NH_DIAM_2D(nh_radius);
+    const bhm_neurons_soa_t* prev_soa = &(prev_cortex->soa);
+    const bhm_bool_t advance_rand = prev_cortex->rand_mode == BHM_RAND_MODE_CONTINUOUS;
+
+    const __m256i fire_threshold = _mm256_set1_epi32(prev_cortex->fire_threshold);
+    const __m256i recovery_value = _mm256_set1_epi32(prev_cortex->recovery_value);
+    const __m256i exc_value = _mm256_set1_epi32(prev_cortex->exc_value);
+    const __m256i inh_value = _mm256_set1_epi32(-prev_cortex->exc_value);
+
+    bhm_cortex_size_t x = xa;
+
+    for (; x + 8 <= xb; x += 8) {
+        bhm_cortex_size_t neuron_index = IDX2D(x, y, width);
+
+        __m256i value = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) &(prev_soa->value[neuron_index])));
+        __m256i rand_state = _mm256_loadu_si256((const __m256i*) &(prev_soa->rand_state[neuron_index]));
+        __m256i ac_lo[BHM_NH_MASK_WORDS], ac_hi[BHM_NH_MASK_WORDS];
+        __m256i ex_lo[BHM_NH_MASK_WORDS], ex_hi[BHM_NH_MASK_WORDS];
+        __m256i str_c_lo[BHM_NH_MASK_WORDS], str_c_hi[BHM_NH_MASK_WORDS];
+        avx2_load_masks(&(prev_soa->synac_mask[neuron_index]), ac_lo, ac_hi);
+        avx2_load_masks(&(prev_soa->synex_mask[neuron_index]), ex_lo, ex_hi);
+        avx2_load_masks(&(prev_soa->synstr_mask_c[neuron_index]), str_c_lo, str_c_hi);
+
+        for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+            bhm_cortex_size_t neighbor_y = y + (j - nh_radius);
+
+            // Rows past open edges hold no neighbors for any lane.
+            if (!nh_resolve(prev_cortex->boundary_mode, prev_cortex->height, &neighbor_y)) {
+                continue;
+            }
+
+            for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+                // Exclude the central neuron from the list of neighbors.
+                if (j == nh_radius && i == nh_radius) {
+                    continue;
+                }
+
+                bhm_cortex_size_t neighbor_x = x + (i - nh_radius);
+                uint32_t valid_bits = 0xFFU;
+                __m256i neighbor_value;
+
+                if (neighbor_x >= 0 && neighbor_x + 8 <= width) {
+                    neighbor_value = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) &(prev_soa->value[IDX2D(neighbor_x, neighbor_y, width)])));
+                } else {
+                    // Some lanes' neighbors lie past the cortex' edges: gather the valid ones only.
+                    bhm_neuron_value_t lane_values[8] = {0};
+                    valid_bits = 0x00U;
+                    for (bhm_cortex_size_t l = 0; l < 8; l++) {
+                        bhm_cortex_size_t lane_x = neighbor_x + l;
+                        if (nh_resolve(prev_cortex->boundary_mode, width, &lane_x)) {
+                            lane_values[l] = prev_soa->value[IDX2D(lane_x, neighbor_y, width)];
+                            valid_bits |= 0x01U << l;
+                        }
+                    }
+                    neighbor_value = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) lane_values));
+                }
+
+                bhm_cortex_size_t neighbor_nh_index = IDX2D(i, j, nh_diameter);
+                bhm_cortex_size_t word = NH_MASK_WORD(neighbor_nh_index);
+                bhm_cortex_size_t bit = NH_MASK_WORD_BIT(neighbor_nh_index);
+
+                // Only active synapses from firing neighbors are integrated.
+                __m256i integrate = _mm256_and_si256(
+                    avx2_expand_bits(avx2_mask_bits(ac_lo[word], ac_hi[word], bit) & valid_bits),
+                    _mm256_cmpgt_epi32(neighbor_value, fire_threshold)
+                );
+
+                // Influence is doubled for synapses whose strength has the highest bit set (strength / 4 + 1).
+                __m256i influence = _mm256_blendv_epi8(inh_value, exc_value, avx2_expand_bits(avx2_mask_bits(ex_lo[word], ex_hi[word], bit)));
+                influence = _mm256_add_epi32(influence, _mm256_and_si256(influence, avx2_expand_bits(avx2_mask_bits(str_c_lo[word], str_c_hi[word], bit))));
+                influence = avx2_wrap16(influence);
+
+                // Clamp to the recovery value on the way down.
+                __m256i sum = _mm256_add_epi32(value, influence);
+                __m256i integrated = _mm256_blendv_epi8(avx2_wrap16(sum), recovery_value, _mm256_cmpgt_epi32(recovery_value, sum));
+                value = _mm256_blendv_epi8(value, integrated, integrate);
+
+                // Random states advance once per valid neighbor, unless they only advance on evolution ticks.
+                if (advance_rand) {
+                    rand_state = _mm256_blendv_epi8(rand_state, avx2_xorshf32(rand_state), avx2_expand_bits(valid_bits));
+                }
+            }
+        }
+
+        int32_t lane_values[8];
+        uint32_t lane_rand_states[8];
+        _mm256_storeu_si256((__m256i*) lane_values, value);
+        _mm256_storeu_si256((__m256i*) lane_rand_states, rand_state);
+        c2d_tick_soa_lanes_epilogue(prev_cortex, next_cortex, neuron_index, 8, lane_values, lane_rand_states);
+    }
+
+    // Remaining neurons are too few to fill a vector.
+    for (; x < xb; x++) {
+        c2d_tick_soa_neuron(prev_cortex, next_cortex, x, y, BHM_FALSE);
+    }
+}
+
+/// @brief Extracts bit [bit] from 16 64-bit masks, stored 8 in [lo] and 8 in [hi].
+__attribute__((target("avx512f")))
+static inline __mmask16 avx512_mask_bits(__m512i lo, __m512i hi, bhm_cortex_size_t bit) {
+    const __m512i one = _mm512_set1_epi64(0x01);
+    __m128i shift = _mm_cvtsi32_si128(bit);
+    return (__mmask16) (_mm512_test_epi64_mask(_mm512_srl_epi64(lo, shift), one) |
+                        ((uint32_t) _mm512_test_epi64_mask(_mm512_srl_epi64(hi, shift), one) << 8));
+}
+
+/// @brief Loads the 16 masks starting at [masks], 8 in [lo] and 8 in [hi], one vector per 64 bits word of theirs.
+/// Wide masks are transposed so that each vector holds the same word of 8 masks, ready for avx512_mask_bits.
+__attribute__((target("avx512f")))
+static inline void avx512_load_masks(const bhm_nh_mask_t* masks, __m512i lo[BHM_NH_MASK_WORDS], __m512i hi[BHM_NH_MASK_WORDS]) {
+#ifdef BHM_WIDE_NH
+    const __m512i even_words = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m512i odd_words = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+    __m512i lo_a = _mm512_loadu_si512(&(masks[0]));
+    __m512i lo_b = _mm512_loadu_si512(&(masks[4]));
+    __m512i hi_a = _mm512_loadu_si512(&(masks[8]));
+    __m512i hi_b = _mm512_loadu_si512(&(masks[12]));
+    lo[0] = _mm512_permutex2var_epi64(lo_a, even_words, lo_b);
+    lo[1] = _mm512_permutex2var_epi64(lo_a, odd_words, lo_b);
+    hi[0] = _mm512_permutex2var_epi64(hi_a, even_words, hi_b);
+    hi[1] = _mm512_permutex2var_epi64(hi_a, odd_words, hi_b);
+#else
+    lo[0] = _mm512_loadu_si512(&(masks[0]));
+    hi[0] = _mm512_loadu_si512(&(masks[8]));
+#endif
+}
+
+/// @brief Advances 16 xorshf32 random states at once.
+__attribute__((target("avx512f")))
+static inline __m512i avx512_xorshf32(__m512i state) {
+    state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 13));
+    state = _mm512_xor_si512(state, _mm512_srli_epi32(state, 17));
+    state = _mm512_xor_si512(state, _mm512_slli_epi32(state, 5));
+    return state;
+}
+
+/// @brief Wraps each 32-bit lane to the 16-bit range, just like storing it to a bhm_neuron_value_t would.
+__attribute__((target("avx512f")))
+static inline __m512i avx512_wrap16(__m512i values) {
+    return _mm512_srai_epi32(_mm512_slli_epi32(values, 16), 16);
+}
+
+/// @brief Non-evolution update of the neurons in [xa, xb) of row [y] of a cortex in SOA storage mode, 16 horizontally adjacent neurons at a time using AVX-512.
+/// Same as c2d_tick_soa_avx2_span, with lanes selected through mask registers instead of blends.
+__attribute__((target("avx512f")))
+static void c2d_tick_soa_avx512_span(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t xa,
+    bhm_cortex_size_t xb
+) {
+    const bhm_cortex_size_t width = prev_cortex->width;
+    const bhm_nh_radius_t nh_radius = prev_cortex->nh_radius;
+    const bhm_cortex_size_t nh_diameter = NH_DIAM_2D(nh_radius);
+    const bhm_neurons_soa_t* prev_soa = &(prev_cortex->soa);
+    const bhm_bool_t advance_rand = prev_cortex->rand_mode == BHM_RAND_MODE_CONTINUOUS;
+
+    const __m512i fire_threshold = _mm512_set1_epi32(prev_cortex->fire_threshold);
+    const __m512i recovery_value = _mm512_set1_epi32(prev_cortex->recovery_value);
+    const __m512i exc_value = _mm512_set1_epi32(prev_cortex->exc_value);
+    const __m512i inh_value = _mm512_set1_epi32(-prev_cortex->exc_value);
+
+    bhm_cortex_size_t x = xa;
+
+    for (; x + 16 <= xb; x += 16) {
+        bhm_cortex_size_t neuron_index = IDX2D(x, y, width);
+
+        __m512i value = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*) &(prev_soa->value[neuron_index])));
+        __m512i rand_state = _mm512_loadu_si512(&(prev_soa->rand_state[neuron_index]));
+        __m512i ac_lo[BHM_NH_MASK_WORDS], ac_hi[BHM_NH_MASK_WORDS];
+        __m512i ex_lo[BHM_NH_MASK_WORDS], ex_hi[BHM_NH_MASK_WORDS];
+        __m512i str_c_lo[BHM_NH_MASK_WORDS], str_c_hi[BHM_NH_MASK_WORDS];
+        avx512_load_masks(&(prev_soa->synac_mask[neuron_index]), ac_lo, ac_hi);
+        avx512_load_masks(&(prev_soa->synex_mask[neuron_index]), ex_lo, ex_hi);
+        avx512_load_masks(&(prev_soa->synstr_mask_c[neuron_index]), str_c_lo, str_c_hi);
+
+        for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+            bhm_cortex_size_t neighbor_y = y + (j - nh_radius);
+
+            // Rows past open edges hold no neighbors for any lane.
+            if (!nh_resolve(prev_cortex->boundary_mode, prev_cortex->height, &neighbor_y)) {
+                continue;
+            }
+
+            for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+                // Exclude the central neuron from the list of neighbors.
+                if (j == nh_radius && i == nh_radius) {
+                    continue;
+                }
+
+                bhm_cortex_size_t neighbor_x = x + (i - nh_radius);
+                __mmask16 valid = 0xFFFFU;
+                __m512i neighbor_value;
+
+                if (neighbor_x >= 0 && neighbor_x + 16 <= width) {
+                    neighbor_value = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*) &(prev_soa->value[IDX2D(neighbor_x, neighbor_y, width)])));
+                } else {
+                    // Some lanes' neighbors lie past the cortex' edges: gather the valid ones only.
+                    bhm_neuron_value_t lane_values[16] = {0};
+                    valid = 0x0000U;
+                    for (bhm_cortex_size_t l = 0; l < 16; l++) {
+                        bhm_cortex_size_t lane_x = neighbor_x + l;
+                        if (nh_resolve(prev_cortex->boundary_mode, width, &lane_x)) {
+                            lane_values[l] = prev_soa->value[IDX2D(lane_x, neighbor_y, width)];
+                            valid |= 0x01U << l;
+                        }
+                    }
+                    neighbor_value = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*) lane_values));
+                }
+
+                bhm_cortex_size_t neighbor_nh_index = IDX2D(i, j, nh_diameter);
+                bhm_cortex_size_t word = NH_MASK_WORD(neighbor_nh_index);
+                bhm_cortex_size_t bit = NH_MASK_WORD_BIT(neighbor_nh_index);
+
+                // Only active synapses from firing neighbors are integrated.
+                __mmask16 integrate = avx512_mask_bits(ac_lo[word], ac_hi[word], bit) & valid &
+                                      _mm512_cmpgt_epi32_mask(neighbor_value, fire_threshold);
+
+                // Influence is doubled for synapses whose strength has the highest bit set (strength / 4 + 1).
+                __m512i influence = _mm512_mask_blend_epi32(avx512_mask_bits(ex_lo[word], ex_hi[word], bit), inh_value, exc_value);
+                influence = _mm512_mask_add_epi32(influence, avx512_mask_bits(str_c_lo[word], str_c_hi[word], bit), influence, influence);
+                influence = avx512_wrap16(influence);
+
+                // Clamp to the recovery value on the way down.
+                __m512i sum = _mm512_add_epi32(value, influence);
+                __m512i integrated = _mm512_mask_blend_epi32(_mm512_cmpgt_epi32_mask(recovery_value, sum), avx512_wrap16(sum), recovery_value);
+                value = _mm512_mask_mov_epi32(value, integrate, integrated);
+
+                // Random states advance once per valid neighbor, unless they only advance on evolution ticks.
+                if (advance_rand) {
+                    rand_state = _mm512_mask_mov_epi32(rand_state, valid, avx512_xorshf32(rand_state));
+                }
+            }
+        }
+
+        int32_t lane_values[16];
+        uint32_t lane_rand_states[16];
+        _mm512_storeu_si512(lane_values, value);
+        _mm512_storeu_si512(lane_rand_states, rand_state);
+        c2d_tick_soa_lanes_epilogue(prev_cortex, next_cortex, neuron_index, 16, lane_values, lane_rand_states);
+    }
+
+    // Remaining neurons are too few to fill a vector.
+    for (; x < xb; x++) {
+        c2d_tick_soa_neuron(prev_cortex, next_cortex, x, y, BHM_FALSE);
+    }
+}
+
+#endif
+
+/// @brief Runs the widest vectorized non-evolution kernel supported by the current CPU over all tiles of the cortex.
+/// Must be called by all threads of the current team.
+/// @return Whether a vectorized kernel was available or not. If not, the cortex is left untouched.
+static bhm_bool_t c2d_tick_soa_simd(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_output2d_t* const* outputs,
+    bhm_cortex_size_t outputs_count
+) {
+#ifdef __BHM_X86__
+    bhm_bool_t avx512 = __builtin_cpu_supports("avx512f");
+    if (!avx512 && !__builtin_cpu_supports("avx2")) {
+        return BHM_FALSE;
+    }
+
+    bhm_cortex_size_t tiles_width, tiles_height;
+    c2d_tiles_count(prev_cortex, &tiles_width, &tiles_height);
+
+    #pragma omp for collapse(2) schedule(static)
+    for (bhm_cortex_size_t ty = 0; ty < tiles_height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < tiles_width; tx++) {
+            bhm_cortex_size_t x0, y0, x1, y1;
+            c2d_tile_bounds(prev_cortex, tx, ty, &x0, &y0, &x1, &y1);
+
+            for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                if (avx512) {
+                    c2d_tick_soa_avx512_span(prev_cortex, next_cortex, y, x0, x1);
+                } else {
+                    c2d_tick_soa_avx2_span(prev_cortex, next_cortex, y, x0, x1);
+                }
+
+                // Publish the row and read outputs from it while it's still in cache.
+                c2d_publish_fired_span(next_cortex, y, x0, x1);
+                c2d_read_span(next_cortex, outputs, outputs_count, y, x0, x1);
+            }
+        }
+    }
+
+    return BHM_TRUE;
+#else
+    return BHM_FALSE;
+#endif
+}
+
+/// @brief Tells whether the tick of the provided cortex run when its ticks count is [ticks_count] is an evolution tick or not.
+static inline bhm_bool_t c2d_evolves_at(const bhm_cortex2d_t* cortex, bhm_ticks_count_t ticks_count) {
+    // evol_step is incremented by 1 to account for edge cases and human readable behavior:
+    // 0x0000 -> 0 + 1 = 1, so the cortex evolves at every tick, meaning that there are no free ticks between evolutions.
+    // 0xFFFF -> 65535 + 1 = 65536, so the cortex never evolves, meaning that there is an infinite amount of ticks between evolutions.
+    return (ticks_count % (((bhm_evol_step_t) cortex->evol_step) + 1)) == 0;
+}
+
+/// @brief Performs a full run cycle over the provided cortex, sharing the work among the current thread team.
+/// Must be called by all threads of the team, which are all done with the tick by the time they return.
+/// @param outputs Outputs to read from [next_cortex] as its rows are updated, in place of as many calls to c2d_read2d after the tick.
+/// @param outputs_count The amount of outputs in [outputs].
+static void c2d_tick_team(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_output2d_t* const* outputs,
+    bhm_cortex_size_t outputs_count
+) {
+    // Defines whether to evolve or not.
+    bhm_bool_t evolve = c2d_evolves_at(prev_cortex, prev_cortex->ticks_count);
+
+    // Non-evolution ticks read neighbors' firing state from the fired bitmap, border neurons through its ghost border.
+    if (!evolve) {
+        c2d_sync_fired_team(prev_cortex);
+        c2d_refresh_ghosts_team(prev_cortex);
+    }
+
+    bhm_bool_t events_enabled = c2d_events_enabled(prev_cortex);
+
+    if (!evolve && events_enabled && prev_cortex->events.valid) {
+        c2d_tick_events(prev_cortex, next_cortex, outputs, outputs_count);
+    } else {
+        // Only SOA storage has a SIMD kernel. Evolution ticks are only run by the scalar kernel, and so are cortices whose rows are not contiguous.
+        if (prev_cortex->storage_mode != BHM_STORAGE_MODE_SOA ||
+            evolve ||
+            prev_cortex->layout != BHM_LAYOUT_ROW_MAJOR ||
+            prev_cortex->tick_mode != BHM_TICK_MODE_SIMD ||
+            prev_cortex->integration_mode != BHM_INTEGRATION_MODE_SEQUENTIAL ||
+            !c2d_tick_soa_simd(prev_cortex, next_cortex, outputs, outputs_count)) {
+            c2d_tick_tiles(prev_cortex, next_cortex, evolve, outputs, outputs_count);
+        }
+
+        // Full ticks don't track activity, so rebuild it if the next tick can make use of it.
+        if (events_enabled) {
+            c2d_scan_events_team(next_cortex);
+        } else {
+            #pragma omp single
+            next_cortex->events.valid = BHM_FALSE;
+        }
+    }
+
+    #pragma omp single
+    {
+        // All kernels publish the fired bitmap of the updated cortex, but not its ghost border.
+        next_cortex->fired.valid = BHM_TRUE;
+        next_cortex->fired.ghosts_valid = BHM_FALSE;
+
+        // Record where the updated cortex comes from, so that the next event-driven tick knows which tiles both cortices share.
+        next_cortex->events.version++;
+        next_cortex->events.source = prev_cortex;
+        next_cortex->events.source_version = prev_cortex->events.version;
+
+        next_cortex->ticks_count++;
+    }
+}
+
+void c2d_tick(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex) {
+    #pragma omp parallel
+    c2d_tick_team(prev_cortex, next_cortex, NULL, 0);
+}
+
+bhm_error_code_t c2d_step(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex, bhm_input2d_t* const* inputs, bhm_cortex_size_t inputs_count, bhm_output2d_t* const* outputs, bhm_cortex_size_t outputs_count) {
+    if (prev_cortex->width != next_cortex->width || prev_cortex->height != next_cortex->height) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+    if (prev_cortex->storage_mode != next_cortex->storage_mode || prev_cortex->layout != next_cortex->layout) {
+        return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+
+    #pragma omp parallel
+    {
+        // Inputs are fed in full before ticking, since fed neurons influence neighbors owned by other threads.
+        for (bhm_cortex_size_t i = 0; i < inputs_count; i++) {
+            c2d_feed2d_team(prev_cortex, inputs[i]);
+        }
+
+        c2d_tick_team(prev_cortex, next_cortex, outputs, outputs_count);
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+/// @brief Orders cortices by decreasing amount of neurons, so that the biggest ones are handed out to threads first.
+static int c2d_size_compare_desc(const void* a, const void* b) {
+    const bhm_cortex2d_t* cortex_a = *((bhm_cortex2d_t* const*) a);
+    const bhm_cortex2d_t* cortex_b = *((bhm_cortex2d_t* const*) b);
+    bhm_cortex_size_t size_a = cortex_a->width * cortex_a->height;
+    bhm_cortex_size_t size_b = cortex_b->width * cortex_b->height;
+
+    return (size_a < size_b) - (size_a > size_b);
+}
+
+bhm_error_code_t c2d_tick_batch(bhm_cortex2d_t* const* prev_cortices, bhm_cortex2d_t* const* next_cortices, bhm_cortex_size_t count) {
+    if (count <= 0) {
+        return BHM_ERROR_NONE;
+    }
+
+    for (bhm_cortex_size_t i = 0; i < count; i++) {
+        if (prev_cortices[i]->width != next_cortices[i]->width || prev_cortices[i]->height != next_cortices[i]->height) {
+            return BHM_ERROR_SIZE_WRONG;
+        }
+        if (prev_cortices[i]->storage_mode != next_cortices[i]->storage_mode || prev_cortices[i]->layout != next_cortices[i]->layout) {
+            return BHM_ERROR_STORAGE_MODE_WRONG;
+        }
+    }
+
+#ifdef _OPENMP
+    int threads_count = omp_get_max_threads();
+#else
+    int threads_count = 1;
+#endif
+
+    // Pairs are split by size: cortices with enough tiles to keep the whole team busy are ticked by all threads, one after the other,
+    // while smaller ones are each ticked by a single thread, many at once.
+    // Pairs are stored as two consecutive pointers, so that they can be sorted together.
+    bhm_cortex2d_t** pairs = (bhm_cortex2d_t**) malloc(2 * count * sizeof(bhm_cortex2d_t*));
+    if (pairs == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    bhm_cortex_size_t shared_count = 0;
+    bhm_cortex_size_t single_count = 0;
+    for (bhm_cortex_size_t i = 0; i < count; i++) {
+        bhm_cortex_size_t tiles_width, tiles_height;
+        c2d_tiles_count(prev_cortices[i], &tiles_width, &tiles_height);
+
+        // Shared pairs fill the array from the front, single ones from the back.
+        bhm_cortex_size_t index = tiles_width * tiles_height >= BHM_BATCH_SHARED_TILES * threads_count ? shared_count++ : count - ++single_count;
+        pairs[2 * index] = prev_cortices[i];
+        pairs[2 * index + 1] = next_cortices[i];
+    }
+    bhm_cortex2d_t** single_pairs = &(pairs[2 * shared_count]);
+    qsort(single_pairs, single_count, 2 * sizeof(bhm_cortex2d_t*), c2d_size_compare_desc);
+
+    #pragma omp parallel
+    {
+        for (bhm_cortex_size_t i = 0; i < shared_count; i++) {
+            c2d_tick_team(pairs[2 * i], pairs[2 * i + 1], NULL, 0);
+        }
+
+        // Biggest cortices go first, so that the smallest ones fill the gaps at the end.
+        #pragma omp for schedule(dynamic, 1)
+        for (bhm_cortex_size_t i = 0; i < single_count; i++) {
+            #pragma omp parallel num_threads(1)
+            c2d_tick_team(single_pairs[2 * i], single_pairs[2 * i + 1], NULL, 0);
+        }
+    }
+
+    free(pairs);
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_run(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex, bhm_ticks_count_t ticks, bhm_tick_hook_t hook, void* hook_data) {
+    if (prev_cortex->width != next_cortex->width || prev_cortex->height != next_cortex->height) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+    if (prev_cortex->storage_mode != next_cortex->storage_mode || prev_cortex->layout != next_cortex->layout) {
+        return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+
+    // A single team lives through all ticks: phases are only separated by the barriers ending each of them.
+    #pragma omp parallel
+    for (bhm_ticks_count_t tick = 0; tick < ticks; tick++) {
+        bhm_cortex2d_t* current = tick % 2 ? next_cortex : prev_cortex;
+        bhm_cortex2d_t* other = tick % 2 ? prev_cortex : next_cortex;
+
+        if (hook != NULL) {
+            #pragma omp single
+            hook(current, tick, hook_data);
+        }
+
+        c2d_tick_team(current, other, NULL, 0);
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+
+// ########################################## Lockstep ensemble tick ##########################################
+
+/// @brief Properties of all lanes of an ensemble, widened to 32 bits and laid out as arrays, so that the lanes of a neuron can be updated side by side.
+typedef struct {
+    int32_t* fire_threshold;
+    int32_t* recovery_value;
+    int32_t* exc_value;
+    int32_t* decay_value;
+    uint32_t* pulse_window;
+    // All ones for lanes whose random states advance at each neighbor on non-evolution ticks, all zeros for the others.
+    uint32_t* advance_rand;
+} bhm_lane_params_t;
+
+/// @brief Updates lane [lane] of the neuron at the provided coordinates of an ensemble, just like c2d_tick_soa_neuron updates the neuron in its own cortex.
+static inline void e2d_tick_lane_neuron(
+    bhm_ensemble2d_t* ensemble,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_population_size_t lane,
+    bhm_bool_t evolve
+) {
+    bhm_cortex2d_t* cortex = &(ensemble->lanes[lane]);
+    const bhm_population_size_t lanes_count = ensemble->lanes_count;
+    bhm_cortex_size_t nh_diameter = NH_DIAM_2D(ensemble->nh_radius);
+    bhm_cortex_size_t neuron_index = IDX2D(x, y, ensemble->width);
+    bhm_cortex_size_t index = neuron_index * lanes_count + lane;
+
+    // Gather the involved neuron, working on local copies.
+    bhm_neuron_t prev_neuron;
+    soa_load_neuron(&(ensemble->soa), index, &prev_neuron);
+    bhm_neuron_t next_neuron = prev_neuron;
+
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8];
+    if (evolve && cortex->rand_mode == BHM_RAND_MODE_COUNTER) {
+        c2d_counter_randoms(cortex, neuron_index, prev_neuron.rand_state, counter_randoms);
+    }
+
+    bhm_nh_mask_t fired_nh_mask = 0x00U;
+    for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+        for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+            bhm_cortex_size_t neighbor_x = x + (i - ensemble->nh_radius);
+            bhm_cortex_size_t neighbor_y = y + (j - ensemble->nh_radius);
+
+            // Exclude the central neuron from the list of neighbors, along with neighbors past open edges.
+            if ((j != ensemble->nh_radius || i != ensemble->nh_radius) &&
+                nh_resolve(ensemble->boundary_mode, ensemble->width, &neighbor_x) &&
+                nh_resolve(ensemble->boundary_mode, ensemble->height, &neighbor_y)) {
+                bhm_cortex_size_t neighbor_index = IDX2D(neighbor_x, neighbor_y, ensemble->width) * lanes_count + lane;
+
+                n2d_tick_synapse(
+                    cortex,
+                    cortex,
+                    &prev_neuron,
+                    &next_neuron,
+                    ensemble->soa.value[neighbor_index],
+                    ensemble->soa.pulse[neighbor_index],
+                    IDX2D(i, j, nh_diameter),
+                    evolve,
+                    counter_randoms,
+                    &fired_nh_mask
+                );
+            }
+        }
+    }
+
+    if (cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) {
+        next_neuron.value = n2d_popcount_integrated_value(cortex, &prev_neuron, fired_nh_mask);
+    }
+
+    n2d_tick_epilogue(cortex, cortex, &prev_neuron, &next_neuron);
+
+    // Static state is shared by both buffers and only changes on evolution ticks: each neuron only ever reads its own, so it's written in place.
+    if (evolve) {
+        soa_store_static(&(ensemble->next_soa), index, &next_neuron);
+    }
+    soa_store_dynamic(&(ensemble->next_soa), index, &next_neuron);
+}
+
+/// @brief Updates lanes [l0] to [l0] + [count] of the neuron at the provided coordinates of an ensemble on a non-evolution tick with sequential integration.
+/// Each step is a branchless loop over lanes, so that it compiles to vector instructions updating one cortex per vector lane.
+/// @param count The amount of lanes to update, at most BHM_ENSEMBLE_BLOCK_LANES.
+__attribute__((always_inline))
+static inline void e2d_tick_lanes_block(
+    bhm_ensemble2d_t* ensemble,
+    const bhm_lane_params_t* params,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t l0,
+    bhm_cortex_size_t count
+) {
+    const bhm_cortex_size_t lanes_count = ensemble->lanes_count;
+    const bhm_cortex_size_t width = ensemble->width;
+    const bhm_nh_radius_t nh_radius = ensemble->nh_radius;
+    const bhm_cortex_size_t nh_diameter = NH_DIAM_2D(nh_radius);
+    const bhm_neurons_soa_t* prev_soa = &(ensemble->soa);
+    bhm_neurons_soa_t* next_soa = &(ensemble->next_soa);
+    const bhm_cortex_size_t index = IDX2D(x, y, width) * lanes_count + l0;
+
+    const int32_t* fire_threshold = &(params->fire_threshold[l0]);
+    const int32_t* recovery_value = &(params->recovery_value[l0]);
+    const int32_t* exc_value = &(params->exc_value[l0]);
+    const int32_t* decay_value = &(params->decay_value[l0]);
+    const uint32_t* pulse_window = &(params->pulse_window[l0]);
+    const uint32_t* advance_rand = &(params->advance_rand[l0]);
+
+    int32_t values[BHM_ENSEMBLE_BLOCK_LANES];
+    uint32_t rand_states[BHM_ENSEMBLE_BLOCK_LANES];
+    for (bhm_cortex_size_t l = 0; l < count; l++) {
+        values[l] = prev_soa->value[index + l];
+        rand_states[l] = prev_soa->rand_state[index + l];
+    }
+
+    // Masks are split into 32 bits words, so that lanes are processed 32 bits wide all along.
+    uint32_t synac_words[BHM_NH_MASK_WORDS * 2][BHM_ENSEMBLE_BLOCK_LANES];
+    uint32_t synex_words[BHM_NH_MASK_WORDS * 2][BHM_ENSEMBLE_BLOCK_LANES];
+    uint32_t synstr_c_words[BHM_NH_MASK_WORDS * 2][BHM_ENSEMBLE_BLOCK_LANES];
+    for (bhm_cortex_size_t w = 0; w < BHM_NH_MASK_WORDS * 2; w++) {
+        for (bhm_cortex_size_t l = 0; l < count; l++) {
+            synac_words[w][l] = (uint32_t) (prev_soa->synac_mask[index + l] >> (w * 32));
+            synex_words[w][l] = (uint32_t) (prev_soa->synex_mask[index + l] >> (w * 32));
+            synstr_c_words[w][l] = (uint32_t) (prev_soa->synstr_mask_c[index + l] >> (w * 32));
+        }
+    }
+
+    for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
+        bhm_cortex_size_t neighbor_y = y + (j - nh_radius);
+        if (!nh_resolve(ensemble->boundary_mode, ensemble->height, &neighbor_y)) {
+            continue;
+        }
+
+        for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
+            bhm_cortex_size_t neighbor_x = x + (i - nh_radius);
+
+            // Exclude the central neuron and neighbors past open edges, which are the same for all lanes.
+            if ((j == nh_radius && i == nh_radius) || !nh_resolve(ensemble->boundary_mode, width, &neighbor_x)) {
+                continue;
+            }
+
+            const bhm_cortex_size_t neighbor_nh_index = IDX2D(i, j, nh_diameter);
+            const bhm_neuron_value_t* neighbor_values = &(prev_soa->value[IDX2D(neighbor_x, neighbor_y, width) * lanes_count + l0]);
+            const uint32_t* synac_word = synac_words[neighbor_nh_index / 32];
+            const uint32_t* synex_word = synex_words[neighbor_nh_index / 32];
+            const uint32_t* synstr_c_word = synstr_c_words[neighbor_nh_index / 32];
+            const uint32_t bit = neighbor_nh_index % 32;
+
+            for (bhm_cortex_size_t l = 0; l < count; l++) {
+                // Random states advance once per valid neighbor, unless they only advance on evolution ticks.
+                uint32_t rand_state = rand_states[l];
+                rand_states[l] = (xorshf32_inline(rand_state) & advance_rand[l]) | (rand_state & ~advance_rand[l]);
+
+                uint32_t active = (synac_word[l] >> bit) & 0x01U;
+                uint32_t excitatory = (synex_word[l] >> bit) & 0x01U;
+                uint32_t strong = (synstr_c_word[l] >> bit) & 0x01U;
+                uint32_t firing = neighbor_values[l] > fire_threshold[l] ? 0x01U : 0x00U;
+
+                // Influence is doubled for synapses whose strength has the highest bit set (strength / 4 + 1).
+                int32_t influence = excitatory ? exc_value[l] : -exc_value[l];
+                influence = (bhm_neuron_value_t) (influence + (strong ? influence : 0x00));
+
+                // Clamp to the recovery value on the way down.
+                int32_t sum = values[l] + influence;
+                int32_t integrated = sum < recovery_value[l] ? recovery_value[l] : (bhm_neuron_value_t) sum;
+
+                // Only active synapses from firing neighbors are integrated.
+                values[l] = (active & firing) ? integrated : values[l];
+            }
+        }
+    }
+
+    const bhm_neuron_value_t* prev_values = &(prev_soa->value[index]);
+    const bhm_ticks_count_t* prev_pulses = &(prev_soa->pulse[index]);
+    const bhm_pulse_mask_t* prev_pulse_masks = &(prev_soa->pulse_mask[index]);
+    bhm_neuron_value_t* next_values = &(next_soa->value[index]);
+    bhm_ticks_count_t* next_pulses = &(next_soa->pulse[index]);
+    bhm_pulse_mask_t* next_pulse_masks = &(next_soa->pulse_mask[index]);
+    bhm_rand_state_t* next_rand_states = &(next_soa->rand_state[index]);
+
+    for (bhm_cortex_size_t l = 0; l < count; l++) {
+        int32_t prev_value = prev_values[l];
+        int32_t prev_pulse = prev_pulses[l];
+        bhm_pulse_mask_t prev_pulse_mask = prev_pulse_masks[l];
+
+        int32_t decay = decay_value[l];
+        int32_t recovery = recovery_value[l];
+
+        // Push to equilibrium by decaying to zero, both from above and below.
+        int32_t value = (bhm_neuron_value_t) (values[l] + (prev_value > 0x00 ? -decay : 0x00) + (prev_value < 0x00 ? decay : 0x00));
+
+        // Bring the neuron back to recovery if it just fired, dropping the oldest recorded pulse out of the window.
+        int32_t fired = prev_value > fire_threshold[l] + prev_pulse ? 0x01 : 0x00;
+        int32_t oldest_pulse = (int32_t) ((prev_pulse_mask >> pulse_window[l]) & 0x01U);
+
+        next_values[l] = (bhm_neuron_value_t) (fired ? recovery : value);
+        next_pulses[l] = (bhm_ticks_count_t) (prev_pulse - oldest_pulse + fired);
+        next_pulse_masks[l] = (prev_pulse_mask << 0x01U) | (bhm_pulse_mask_t) fired;
+    }
 
-void c2d_feed2d(bhm_cortex2d_t* cortex, bhm_input2d_t* input) {
-    #pragma omp parallel for collapse(2)
-    for (bhm_cortex_size_t y = input->y0; y < input->y1; y++) {
-        for (bhm_cortex_size_t x = input->x0; x < input->x1; x++) {
-            // Check whether the current input neuron should be excited or not.
-            bhm_bool_t excite = value_to_pulse(
-                cortex->sample_window,
-                cortex->ticks_count % cortex->sample_window,
-                input->values[
-                    IDX2D(
-                        x - input->x0,
-                        y - input->y0,
-                        input->x1 - input->x0
-                    )
-                ],
-                cortex->pulse_mapping
-            );
+    for (bhm_cortex_size_t l = 0; l < count; l++) {
+        next_rand_states[l] = rand_states[l];
+    }
+}
 
-            if (excite) {
-                cortex->neurons[IDX2D(x, y, cortex->width)].value += input->exc_value;
-            }
+/// @brief Updates all lanes of all neurons in row [y] of an ensemble on a non-evolution tick with sequential integration.
+static void e2d_tick_lanes_row(
+    bhm_ensemble2d_t* ensemble,
+    const bhm_lane_params_t* params,
+    bhm_cortex_size_t y
+) {
+    for (bhm_cortex_size_t x = 0; x < ensemble->width; x++) {
+        for (bhm_cortex_size_t l0 = 0; l0 < ensemble->lanes_count; l0 += BHM_ENSEMBLE_BLOCK_LANES) {
+            bhm_cortex_size_t count = ensemble->lanes_count - l0 < BHM_ENSEMBLE_BLOCK_LANES ? ensemble->lanes_count - l0 : BHM_ENSEMBLE_BLOCK_LANES;
+            e2d_tick_lanes_block(ensemble, params, x, y, l0, count);
         }
     }
 }
 
-void c2d_read2d(bhm_cortex2d_t* cortex, bhm_output2d_t* output) {
-    #pragma omp parallel for collapse(2)
-    for (bhm_cortex_size_t y = output->y0; y < output->y1; y++) {
-        for (bhm_cortex_size_t x = output->x0; x < output->x1; x++) {
-            output->values[
-                IDX2D(
-                    x - output->x0,
-                    y - output->y0,
-                    output->x1 - output->x0
-                )
-            ] = cortex->neurons[
-                IDX2D(
-                    x,
-                    y,
-                    cortex->width
-                )
-            ].pulse;
+#ifdef __BHM_X86__
+
+/// @brief Same as e2d_tick_lanes_row, compiled for 256-bit vectors.
+__attribute__((target("avx2")))
+static void e2d_tick_lanes_row_avx2(
+    bhm_ensemble2d_t* ensemble,
+    const bhm_lane_params_t* params,
+    bhm_cortex_size_t y
+) {
+    for (bhm_cortex_size_t x = 0; x < ensemble->width; x++) {
+        for (bhm_cortex_size_t l0 = 0; l0 < ensemble->lanes_count; l0 += BHM_ENSEMBLE_BLOCK_LANES) {
+            bhm_cortex_size_t count = ensemble->lanes_count - l0 < BHM_ENSEMBLE_BLOCK_LANES ? ensemble->lanes_count - l0 : BHM_ENSEMBLE_BLOCK_LANES;
+            e2d_tick_lanes_block(ensemble, params, x, y, l0, count);
         }
     }
 }
 
-void c2d_tick(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex) {
-    #pragma omp parallel for collapse(2)
-    for (bhm_cortex_size_t y = 0; y < prev_cortex->height; y++) {
-        for (bhm_cortex_size_t x = 0; x < prev_cortex->width; x++) {
-            // Retrieve the involved neurons.
-            bhm_cortex_size_t neuron_index = IDX2D(x, y, prev_cortex->width);
-            bhm_neuron_t prev_neuron = prev_cortex->neurons[neuron_index];
-            bhm_neuron_t* next_neuron = &(next_cortex->neurons[neuron_index]);
-
-            // Copy prev neuron values to the new one.
-            *next_neuron = prev_neuron;
-
-            /* Compute the neighborhood diameter:
-                   d = 7
-              <------------->
-               r = 3
-              <----->
-              +-|-|-|-|-|-|-+
-              |             |
-              |             |
-              |      X      |
-              |             |
-              |             |
-              +-|-|-|-|-|-|-+
-            */
-            bhm_cortex_size_t nh_diameter = NH_DIAM_2D(prev_cortex->nh_radius);
-
-            bhm_nh_mask_t prev_ac_mask = prev_neuron.synac_mask;
-            bhm_nh_mask_t prev_exc_mask = prev_neuron.synex_mask;
-            bhm_nh_mask_t prev_str_mask_a = prev_neuron.synstr_mask_a;
-            bhm_nh_mask_t prev_str_mask_b = prev_neuron.synstr_mask_b;
-            bhm_nh_mask_t prev_str_mask_c = prev_neuron.synstr_mask_c;
-
-            // Defines whether to evolve or not.
-            // evol_step is incremented by 1 to account for edge cases and human readable behavior:
-            // 0x0000 -> 0 + 1 = 1, so the cortex evolves at every tick, meaning that there are no free ticks between evolutions.
-            // 0xFFFF -> 65535 + 1 = 65536, so the cortex never evolves, meaning that there is an infinite amount of ticks between evolutions.
-            bhm_bool_t evolve = (prev_cortex->ticks_count % (((bhm_evol_step_t) prev_cortex->evol_step) + 1)) == 0;
-
-            // Increment the current neuron value by reading its connected neighbors.
-            for (bhm_nh_radius_t j = 0; j < nh_diameter; j++) {
-                for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
-                    bhm_cortex_size_t neighbor_x = x + (i - prev_cortex->nh_radius);
-                    bhm_cortex_size_t neighbor_y = y + (j - prev_cortex->nh_radius);
-
-                    // Exclude the central neuron from the list of neighbors.
-                    if ((j != prev_cortex->nh_radius || i != prev_cortex->nh_radius) &&
-                        (neighbor_x >= 0 && neighbor_y >= 0 && neighbor_x < prev_cortex->width && neighbor_y < prev_cortex->height)) {
-                        // The index of the current neighbor in the current neuron's neighborhood.
-                        bhm_cortex_size_t neighbor_nh_index = IDX2D(i, j, nh_diameter);
-                        bhm_cortex_size_t neighbor_index = IDX2D(WRAP(neighbor_x, prev_cortex->width),
-                                                             WRAP(neighbor_y, prev_cortex->height),
-                                                             prev_cortex->width);
-
-                        // Fetch the current neighbor.
-                        bhm_neuron_t neighbor = prev_cortex->neurons[neighbor_index];
-
-                        // Compute the current synapse strength.
-                        bhm_syn_strength_t syn_strength = (prev_str_mask_a & 0x01U) |
-                                                      ((prev_str_mask_b & 0x01U) << 0x01U) |
-                                                      ((prev_str_mask_c & 0x01U) << 0x02U);
-
-                        // Pick a random number for each neighbor, capped to the max uint16 value.
-                        next_neuron->rand_state = xorshf32(next_neuron->rand_state);
-                        bhm_chance_t random = next_neuron->rand_state % 0xFFFFU;
-
-                        // Inverse of the current synapse strength, useful when computing depression probability (synapse deletion and weakening).
-                        bhm_syn_strength_t strength_diff = BHM_MAX_SYN_STRENGTH - syn_strength;
-
-                        // Check if the last bit of the mask is 1 or 0: 1 = active synapse, 0 = inactive synapse.
-                        if (prev_ac_mask & 0x01U) {
-                            bhm_neuron_value_t neighbor_influence = (prev_exc_mask & 0x01U ? prev_cortex->exc_value : -prev_cortex->exc_value) * ((syn_strength / 4) + 1);
-                            if (neighbor.value > prev_cortex->fire_threshold) {
-                                if (next_neuron->value + neighbor_influence < prev_cortex->recovery_value) {
-                                    next_neuron->value = prev_cortex->recovery_value;
-                                } else {
-                                    next_neuron->value += neighbor_influence;
-                                }
-                            }
-                        }
+#endif
 
-                        // Perform the evolution phase if allowed.
-                        if (evolve) {
-                            // Structural plasticity: create or destroy a synapse.
-                            if (!(prev_ac_mask & 0x01U) &&
-                                prev_neuron.syn_count < next_neuron->max_syn_count &&
-                                // Frequency component.
-                                random < prev_cortex->syngen_chance * (bhm_chance_t) neighbor.pulse) {
-                                // Add synapse.
-                                next_neuron->synac_mask |= (0x01UL << neighbor_nh_index);
-
-                                // Set the new synapse's strength to 0.
-                                next_neuron->synstr_mask_a &= ~(0x01UL << neighbor_nh_index);
-                                next_neuron->synstr_mask_b &= ~(0x01UL << neighbor_nh_index);
-                                next_neuron->synstr_mask_c &= ~(0x01UL << neighbor_nh_index);
-
-                                // Define whether the new synapse is excitatory or inhibitory.
-                                if (random % next_cortex->inhexc_range < next_neuron->inhexc_ratio) {
-                                    // Inhibitory.
-                                    next_neuron->synex_mask &= ~(0x01UL << neighbor_nh_index);
-                                } else {
-                                    // Excitatory.
-                                    next_neuron->synex_mask |= (0x01UL << neighbor_nh_index);
-                                }
-
-                                next_neuron->syn_count++;
-                            } else if (prev_ac_mask & 0x01U &&
-                                       // Only 0-strength synapses can be deleted.
-                                       syn_strength <= 0x00U &&
-                                       // Frequency component.
-                                       random < prev_cortex->syngen_chance / (neighbor.pulse + 1)) {
-                                // Delete synapse.
-                                next_neuron->synac_mask &= ~(0x01UL << neighbor_nh_index);
-
-                                next_neuron->syn_count--;
-                            }
-
-                            // Functional plasticity: strengthen or weaken a synapse.
-                            if (prev_ac_mask & 0x01U) {
-                                if (syn_strength < BHM_MAX_SYN_STRENGTH &&
-                                    prev_neuron.tot_syn_strength < prev_cortex->max_tot_strength &&
-                                    random < prev_cortex->synstr_chance * (bhm_chance_t) neighbor.pulse * (bhm_chance_t) strength_diff) {
-                                    syn_strength++;
-                                    next_neuron->synstr_mask_a = (prev_neuron.synstr_mask_a & ~(0x01UL << neighbor_nh_index)) | ((syn_strength & 0x01U) << neighbor_nh_index);
-                                    next_neuron->synstr_mask_b = (prev_neuron.synstr_mask_b & ~(0x01UL << neighbor_nh_index)) | (((syn_strength >> 0x01U) & 0x01U) << neighbor_nh_index);
-                                    next_neuron->synstr_mask_c = (prev_neuron.synstr_mask_c & ~(0x01UL << neighbor_nh_index)) | (((syn_strength >> 0x02U) & 0x01U) << neighbor_nh_index);
-
-                                    next_neuron->tot_syn_strength++;
-                                } else if (syn_strength > 0x00U &&
-                                           random < prev_cortex->synstr_chance / (neighbor.pulse + syn_strength + 1)) {
-                                    syn_strength--;
-                                    next_neuron->synstr_mask_a = (prev_neuron.synstr_mask_a & ~(0x01UL << neighbor_nh_index)) | ((syn_strength & 0x01U) << neighbor_nh_index);
-                                    next_neuron->synstr_mask_b = (prev_neuron.synstr_mask_b & ~(0x01UL << neighbor_nh_index)) | (((syn_strength >> 0x01U) & 0x01U) << neighbor_nh_index);
-                                    next_neuron->synstr_mask_c = (prev_neuron.synstr_mask_c & ~(0x01UL << neighbor_nh_index)) | (((syn_strength >> 0x02U) & 0x01U) << neighbor_nh_index);
-
-                                    next_neuron->tot_syn_strength--;
-                                }
-                            }
-
-                            // Increment evolutions count.
-                            next_cortex->evols_count++;
-                        }
+bhm_error_code_t e2d_tick(bhm_ensemble2d_t* ensemble) {
+    const bhm_population_size_t lanes_count = ensemble->lanes_count;
+
+    // Lanes are updated side by side unless any of them evolves or integrates by popcount, in which case they're updated one by one.
+    bhm_bool_t lockstep = BHM_TRUE;
+    for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+        const bhm_cortex2d_t* lane = &(ensemble->lanes[l]);
+        if (c2d_evolves_at(lane, lane->ticks_count) || lane->integration_mode != BHM_INTEGRATION_MODE_SEQUENTIAL) {
+            lockstep = BHM_FALSE;
+        }
+    }
+
+    if (lockstep) {
+        uint32_t* params_storage = ensemble->lanes_params;
+        bhm_lane_params_t params = {
+            .fire_threshold = (int32_t*) &(params_storage[0 * lanes_count]),
+            .recovery_value = (int32_t*) &(params_storage[1 * lanes_count]),
+            .exc_value = (int32_t*) &(params_storage[2 * lanes_count]),
+            .decay_value = (int32_t*) &(params_storage[3 * lanes_count]),
+            .pulse_window = &(params_storage[4 * lanes_count]),
+            .advance_rand = &(params_storage[5 * lanes_count])
+        };
+        for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+            const bhm_cortex2d_t* lane = &(ensemble->lanes[l]);
+            params.fire_threshold[l] = lane->fire_threshold;
+            params.recovery_value[l] = lane->recovery_value;
+            params.exc_value[l] = lane->exc_value;
+            params.decay_value[l] = lane->decay_value;
+            params.pulse_window[l] = lane->pulse_window;
+            params.advance_rand[l] = lane->rand_mode == BHM_RAND_MODE_CONTINUOUS ? 0xFFFFFFFFU : 0x00U;
+        }
+
+#ifdef __BHM_X86__
+        bhm_bool_t avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+        #pragma omp parallel for schedule(static)
+        for (bhm_cortex_size_t y = 0; y < ensemble->height; y++) {
+#ifdef __BHM_X86__
+            if (avx2) {
+                e2d_tick_lanes_row_avx2(ensemble, &params, y);
+                continue;
+            }
+#endif
+            e2d_tick_lanes_row(ensemble, &params, y);
+        }
+    } else {
+        #pragma omp parallel for schedule(static)
+        for (bhm_cortex_size_t y = 0; y < ensemble->height; y++) {
+            for (bhm_cortex_size_t x = 0; x < ensemble->width; x++) {
+                for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+                    const bhm_cortex2d_t* lane = &(ensemble->lanes[l]);
+                    e2d_tick_lane_neuron(ensemble, x, y, l, c2d_evolves_at(lane, lane->ticks_count));
+                }
+            }
+        }
+    }
+
+    for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+        ensemble->lanes[l].ticks_count++;
+    }
+
+    // The updated state becomes the current one.
+    bhm_neurons_soa_t soa = ensemble->soa;
+    ensemble->soa = ensemble->next_soa;
+    ensemble->next_soa = soa;
+
+    return BHM_ERROR_NONE;
+}
+
+// ########################################## In-place tick ##########################################
+
+/// @brief Copy of consecutive rows of a cortex' state from before an in-place tick.
+/// Neurons read their own state before overwriting it, so only what they read from neighbors needs to be kept aside:
+/// whole neurons in AOS storage mode, values and pulses in SOA storage mode, plus fired bits.
+typedef struct {
+    // First row held.
+    bhm_cortex_size_t base;
+    // Amount of rows held.
+    bhm_cortex_size_t count;
+    // Maximum amount of rows held at once.
+    bhm_cortex_size_t capacity;
+
+    // Held neurons in AOS storage mode, NULL otherwise.
+    bhm_neuron_t* neurons;
+    // Held values and pulses in SOA storage mode, NULL otherwise.
+    bhm_neuron_value_t* values;
+    bhm_ticks_count_t* pulses;
+    // Held fired words, ghost words included, with one extra word past the last row like in fired bitmaps.
+    bhm_fired_word_t* fired_words;
+} bhm_row_window_t;
+
+static void row_window_free(bhm_row_window_t* window) {
+    free(window->neurons);
+    free(window->values);
+    free(window->pulses);
+    free(window->fired_words);
+
+    *window = (bhm_row_window_t) {0};
+}
+
+/// @brief Allocates room for [capacity] rows of the provided cortex in the provided window.
+static bhm_error_code_t row_window_alloc(bhm_row_window_t* window, const bhm_cortex2d_t* cortex, bhm_cortex_size_t capacity) {
+    *window = (bhm_row_window_t) {0};
+    window->capacity = capacity;
+
+    bhm_bool_t failed;
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        window->values = (bhm_neuron_value_t*) malloc(capacity * cortex->width * sizeof(bhm_neuron_value_t));
+        window->pulses = (bhm_ticks_count_t*) malloc(capacity * cortex->width * sizeof(bhm_ticks_count_t));
+        failed = window->values == NULL || window->pulses == NULL;
+    } else {
+        window->neurons = (bhm_neuron_t*) malloc(capacity * cortex->width * sizeof(bhm_neuron_t));
+        failed = window->neurons == NULL;
+    }
+    window->fired_words = (bhm_fired_word_t*) malloc((capacity * cortex->fired.row_stride + 1) * sizeof(bhm_fired_word_t));
+
+    if (failed || window->fired_words == NULL) {
+        row_window_free(window);
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+/// @brief Makes [view] a copy of [cortex] whose neighbor-visible state is read from the rows held by the provided window.
+/// View arrays are offset so that indexes of held rows in the whole cortex land in the window, so any kernel can read them unchanged.
+/// Views have no ghost rows, so their ghost border is never valid.
+static void row_window_view(const bhm_row_window_t* window, const bhm_cortex2d_t* cortex, bhm_cortex2d_t* view) {
+    *view = *cortex;
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        view->soa.value = window->values - window->base * cortex->width;
+        view->soa.pulse = window->pulses - window->base * cortex->width;
+    } else {
+        view->neurons = window->neurons - window->base * cortex->width;
+    }
+    view->fired.words = window->fired_words + 1 - window->base * cortex->fired.row_stride;
+    view->fired.ghosts_valid = BHM_FALSE;
+}
+
+/// @brief Appends row [y] of [source] to the provided window, which must currently end right before it.
+/// [source] is either a cortex or a view of another window.
+static void row_window_push(bhm_row_window_t* window, const bhm_cortex2d_t* source, bhm_cortex_size_t y) {
+    bhm_cortex_size_t row_index = IDX2D(0, window->count, source->width);
+
+    if (source->storage_mode == BHM_STORAGE_MODE_SOA) {
+        memcpy(&(window->values[row_index]), &(source->soa.value[IDX2D(0, y, source->width)]), source->width * sizeof(bhm_neuron_value_t));
+        memcpy(&(window->pulses[row_index]), &(source->soa.pulse[IDX2D(0, y, source->width)]), source->width * sizeof(bhm_ticks_count_t));
+    } else {
+        memcpy(&(window->neurons[row_index]), &(source->neurons[IDX2D(0, y, source->width)]), source->width * sizeof(bhm_neuron_t));
+    }
+    memcpy(
+        &(window->fired_words[IDX2D(0, window->count, source->fired.row_stride)]),
+        &(source->fired.words[IDX2D(-1, y, source->fired.row_stride)]),
+        source->fired.row_stride * sizeof(bhm_fired_word_t)
+    );
+
+    window->count++;
+}
+
+/// @brief Drops all rows before [y] from the provided window, moving the remaining ones to its start.
+static void row_window_drop(bhm_row_window_t* window, const bhm_cortex2d_t* cortex, bhm_cortex_size_t y) {
+    bhm_cortex_size_t dropped = y - window->base;
+    bhm_cortex_size_t kept = window->count - dropped;
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        memmove(window->values, &(window->values[dropped * cortex->width]), kept * cortex->width * sizeof(bhm_neuron_value_t));
+        memmove(window->pulses, &(window->pulses[dropped * cortex->width]), kept * cortex->width * sizeof(bhm_ticks_count_t));
+    } else {
+        memmove(window->neurons, &(window->neurons[dropped * cortex->width]), kept * cortex->width * sizeof(bhm_neuron_t));
+    }
+    memmove(
+        window->fired_words,
+        &(window->fired_words[dropped * cortex->fired.row_stride]),
+        kept * cortex->fired.row_stride * sizeof(bhm_fired_word_t)
+    );
+
+    window->base = y;
+    window->count = kept;
+}
+
+bhm_error_code_t c2d_tick_inplace(bhm_cortex2d_t* cortex) {
+    // Rows are set aside band by band, so rows wrapping around from the opposite edge would already be overwritten.
+    // They're also copied as a whole, so they need to be contiguous in storage.
+    if (cortex->boundary_mode == BHM_BOUNDARY_MODE_TORUS || cortex->layout != BHM_LAYOUT_ROW_MAJOR) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+
+    bhm_bool_t evolve = c2d_evolves_at(cortex, cortex->ticks_count);
+
+    // Non-evolution ticks read neighbors' firing state from the fired bitmap.
+    if (!evolve) {
+        c2d_sync_fired(cortex);
+    }
+
+    bhm_nh_stencil_t stencil;
+    nh_stencil_init(&stencil, cortex);
+
+    // Random states jump over the whole neighborhood at once on non-evolution ticks, if they advance at all.
+    bhm_rand_jump_t rand_jump;
+    bhm_bool_t jump_rand = !evolve && cortex->rand_mode == BHM_RAND_MODE_CONTINUOUS;
+    if (jump_rand) {
+        rand_jump_init(&rand_jump, stencil.count);
+    }
+
+    // Pick the same kernel as full ticks would. Event-driven ticks need a second cortex to skip tiles, so full ticks are run instead.
+    bhm_bool_t avx2 = BHM_FALSE;
+    bhm_bool_t avx512 = BHM_FALSE;
+#ifdef __BHM_X86__
+    if (!evolve &&
+        cortex->storage_mode == BHM_STORAGE_MODE_SOA &&
+        cortex->tick_mode == BHM_TICK_MODE_SIMD &&
+        cortex->integration_mode == BHM_INTEGRATION_MODE_SEQUENTIAL) {
+        avx512 = __builtin_cpu_supports("avx512f");
+        avx2 = __builtin_cpu_supports("avx2");
+    }
+#endif
+
+    // Rows are split into one contiguous band per thread.
+#ifdef _OPENMP
+    bhm_cortex_size_t bands_count = omp_get_max_threads();
+#else
+    bhm_cortex_size_t bands_count = 1;
+#endif
+    if (bands_count > cortex->height) {
+        bands_count = cortex->height;
+    }
+
+    // Each band keeps the rows its neurons read in a rolling window, plus the rows right below it, which belong to the next band.
+    // Windows hold a few neighborhoods worth of rows, so that rows are only moved back once in a while.
+    bhm_cortex_size_t nh_radius = cortex->nh_radius;
+    bhm_cortex_size_t window_capacity = 3 * NH_DIAM_2D(nh_radius);
+    bhm_row_window_t* windows = (bhm_row_window_t*) calloc(bands_count, sizeof(bhm_row_window_t));
+    bhm_row_window_t* halos = (bhm_row_window_t*) calloc(bands_count, sizeof(bhm_row_window_t));
+    bhm_error_code_t error = windows == NULL || halos == NULL ? BHM_ERROR_FAILED_ALLOC : BHM_ERROR_NONE;
+    for (bhm_cortex_size_t b = 0; b < bands_count && error == BHM_ERROR_NONE; b++) {
+        error = row_window_alloc(&(windows[b]), cortex, window_capacity);
+        if (error == BHM_ERROR_NONE) {
+            error = row_window_alloc(&(halos[b]), cortex, nh_radius);
+        }
+    }
+
+    if (error == BHM_ERROR_NONE) {
+        #pragma omp parallel
+        {
+            // Set aside the rows each band reads across its borders, before any of them is overwritten.
+            #pragma omp for schedule(static)
+            for (bhm_cortex_size_t b = 0; b < bands_count; b++) {
+                bhm_cortex_size_t y0 = b * cortex->height / bands_count;
+                bhm_cortex_size_t y1 = (b + 1) * cortex->height / bands_count;
+
+                windows[b].base = y0 - nh_radius > 0 ? y0 - nh_radius : 0;
+                for (bhm_cortex_size_t y = windows[b].base; y < y0; y++) {
+                    row_window_push(&(windows[b]), cortex, y);
+                }
+
+                halos[b].base = y1;
+                for (bhm_cortex_size_t y = y1; y < y1 + nh_radius && y < cortex->height; y++) {
+                    row_window_push(&(halos[b]), cortex, y);
+                }
+            }
+
+            #pragma omp for schedule(static)
+            for (bhm_cortex_size_t b = 0; b < bands_count; b++) {
+                bhm_cortex_size_t y0 = b * cortex->height / bands_count;
+                bhm_cortex_size_t y1 = (b + 1) * cortex->height / bands_count;
+                bhm_row_window_t* window = &(windows[b]);
+
+                bhm_cortex2d_t halo_view;
+                row_window_view(&(halos[b]), cortex, &halo_view);
+
+                for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                    // Slide the window down to hold all rows in the neighborhood of row y, as they were before the tick.
+                    // Rows of the band after y are still untouched, while the ones past its end come from the halo.
+                    bhm_cortex_size_t first_row = y - nh_radius > 0 ? y - nh_radius : 0;
+                    bhm_cortex_size_t end_row = y + nh_radius + 1 < cortex->height ? y + nh_radius + 1 : cortex->height;
+                    if (end_row > window->base + window->capacity) {
+                        row_window_drop(window, cortex, first_row);
                     }
+                    while (window->base + window->count < end_row) {
+                        bhm_cortex_size_t row = window->base + window->count;
+                        row_window_push(window, row < y1 ? cortex : &halo_view, row);
+                    }
+
+                    bhm_cortex2d_t prev_view;
+                    row_window_view(window, cortex, &prev_view);
+
+#ifdef __BHM_X86__
+                    if (avx512) {
+                        c2d_tick_soa_avx512_span(&prev_view, cortex, y, 0, cortex->width);
+                    } else if (avx2) {
+                        c2d_tick_soa_avx2_span(&prev_view, cortex, y, 0, cortex->width);
+                    } else
+#endif
+                    c2d_tick_span(&prev_view, cortex, y, 0, cortex->width, &stencil, jump_rand ? &rand_jump : NULL, evolve);
+
+                    // Previous fired bits of row y are held by the window, so the row can be published right away.
+                    c2d_publish_fired_row(cortex, y);
+                }
+            }
+        }
+    }
+
+    for (bhm_cortex_size_t b = 0; b < bands_count; b++) {
+        if (windows != NULL) {
+            row_window_free(&(windows[b]));
+        }
+        if (halos != NULL) {
+            row_window_free(&(halos[b]));
+        }
+    }
+    free(windows);
+    free(halos);
+
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    cortex->fired.valid = BHM_TRUE;
+    cortex->fired.ghosts_valid = BHM_FALSE;
+
+    // Activity is rebuilt like after full ticks. The cortex no longer holds the state of any other cortex.
+    if (c2d_events_enabled(cortex)) {
+        c2d_scan_events(cortex);
+    } else {
+        cortex->events.valid = BHM_FALSE;
+    }
+    cortex->events.version++;
+    cortex->events.source = NULL;
+
+    cortex->ticks_count++;
+
+    return BHM_ERROR_NONE;
+}
+
+// ########################################## Temporal blocking ##########################################
+
+/// @brief Pair of small cortices a single tile is advanced through several ticks in, along with its halo.
+/// Both share the static state of their neurons, which non-evolution ticks leave untouched.
+typedef struct {
+    bhm_cortex2d_t cortices[2];
+} bhm_tile_block_t;
+
+static void tile_block_free(bhm_tile_block_t* block) {
+    for (int i = 0; i < 2; i++) {
+        c2d_deinit(&(block->cortices[i]));
+    }
+}
+
+/// @brief Allocates the provided block for tiles of [cortex] of up to [width] x [height] neurons, halo included.
+static bhm_error_code_t tile_block_alloc(bhm_tile_block_t* block, const bhm_cortex2d_t* cortex, bhm_cortex_size_t width, bhm_cortex_size_t height) {
+    bhm_error_code_t error = BHM_ERROR_NONE;
+
+    for (int i = 0; i < 2; i++) {
+        // Block cortices inherit all of the cortex' properties, but none of its storage.
+        bhm_cortex2d_t* block_cortex = &(block->cortices[i]);
+        *block_cortex = *cortex;
+        block_cortex->width = width;
+        block_cortex->height = height;
+        block_cortex->neurons = NULL;
+        block_cortex->soa = (bhm_neurons_soa_t) {0};
+        block_cortex->fired = (bhm_fired_bitmap_t) {0};
+        block_cortex->events = (bhm_tile_events_t) {0};
+
+        // Blocks are cut out of the cortex along with a halo, so their own edges hold nothing past them, and copied row by row.
+        block_cortex->boundary_mode = BHM_BOUNDARY_MODE_OPEN;
+        block_cortex->layout = BHM_LAYOUT_ROW_MAJOR;
+
+        if (error == BHM_ERROR_NONE) {
+            error = fired_alloc(&(block_cortex->fired), width, height, cortex->nh_radius);
+        }
+        if (error == BHM_ERROR_NONE) {
+            if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                error = soa_alloc(&(block_cortex->soa), width * height, cortex->page_mode, NULL);
+            } else {
+                error = storage_alloc((void**) &(block_cortex->neurons), width * height * sizeof(bhm_neuron_t), cortex->page_mode, NULL);
+            }
+        }
+    }
+
+    if (error == BHM_ERROR_NONE && cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        error = c2d_share_static(&(block->cortices[1]), &(block->cortices[0]));
+    }
+
+    if (error != BHM_ERROR_NONE) {
+        tile_block_free(block);
+    }
+
+    return error;
+}
+
+/// @brief Copies [count] consecutive neurons from [from_index] of [from] to [to_index] of [to], which must share the same storage mode.
+/// @param with_static Whether to copy the neurons' static state as well in SOA storage mode or not.
+static void c2d_copy_span(
+    bhm_cortex2d_t* to,
+    bhm_cortex_size_t to_index,
+    const bhm_cortex2d_t* from,
+    bhm_cortex_size_t from_index,
+    bhm_cortex_size_t count,
+    bhm_bool_t with_static
+) {
+    if (from->storage_mode != BHM_STORAGE_MODE_SOA) {
+        memcpy(&(to->neurons[to_index]), &(from->neurons[from_index]), count * sizeof(bhm_neuron_t));
+        return;
+    }
+
+    const bhm_neurons_soa_t* from_soa = &(from->soa);
+    bhm_neurons_soa_t* to_soa = &(to->soa);
+
+    if (with_static) {
+        memcpy(&(to_soa->synac_mask[to_index]), &(from_soa->synac_mask[from_index]), count * sizeof(bhm_nh_mask_t));
+        memcpy(&(to_soa->synex_mask[to_index]), &(from_soa->synex_mask[from_index]), count * sizeof(bhm_nh_mask_t));
+        memcpy(&(to_soa->synstr_mask_a[to_index]), &(from_soa->synstr_mask_a[from_index]), count * sizeof(bhm_nh_mask_t));
+        memcpy(&(to_soa->synstr_mask_b[to_index]), &(from_soa->synstr_mask_b[from_index]), count * sizeof(bhm_nh_mask_t));
+        memcpy(&(to_soa->synstr_mask_c[to_index]), &(from_soa->synstr_mask_c[from_index]), count * sizeof(bhm_nh_mask_t));
+        memcpy(&(to_soa->max_syn_count[to_index]), &(from_soa->max_syn_count[from_index]), count * sizeof(bhm_syn_count_t));
+        memcpy(&(to_soa->syn_count[to_index]), &(from_soa->syn_count[from_index]), count * sizeof(bhm_syn_count_t));
+        memcpy(&(to_soa->tot_syn_strength[to_index]), &(from_soa->tot_syn_strength[from_index]), count * sizeof(bhm_syn_strength_t));
+        memcpy(&(to_soa->inhexc_ratio[to_index]), &(from_soa->inhexc_ratio[from_index]), count * sizeof(bhm_chance_t));
+    }
+    memcpy(&(to_soa->rand_state[to_index]), &(from_soa->rand_state[from_index]), count * sizeof(bhm_rand_state_t));
+    memcpy(&(to_soa->pulse_mask[to_index]), &(from_soa->pulse_mask[from_index]), count * sizeof(bhm_pulse_mask_t));
+    memcpy(&(to_soa->pulse[to_index]), &(from_soa->pulse[from_index]), count * sizeof(bhm_ticks_count_t));
+    memcpy(&(to_soa->value[to_index]), &(from_soa->value[from_index]), count * sizeof(bhm_neuron_value_t));
+}
+
+/// @brief Updates the neurons in [xa, xb) of row [y] of [next_cortex], picking the same kernel a full tick would.
+static inline void c2d_tick_block_span(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_cortex_size_t y,
+    bhm_cortex_size_t xa,
+    bhm_cortex_size_t xb,
+    const bhm_nh_stencil_t* stencil,
+    const bhm_rand_jump_t* rand_jump,
+    bhm_bool_t simd
+) {
+#ifdef __BHM_X86__
+    if (simd) {
+        if (__builtin_cpu_supports("avx512f")) {
+            c2d_tick_soa_avx512_span(prev_cortex, next_cortex, y, xa, xb);
+        } else {
+            c2d_tick_soa_avx2_span(prev_cortex, next_cortex, y, xa, xb);
+        }
+        return;
+    }
+#else
+    (void) simd;
+#endif
+
+    c2d_tick_span(prev_cortex, next_cortex, y, xa, xb, stencil, rand_jump, BHM_FALSE);
+}
+
+/// @brief Advances [prev_cortex] by [depth] non-evolution ticks, storing the result in [next_cortex], one tile at a time.
+/// Each tile is copied to a block along with a halo [depth] neighborhood radii wide, then advanced through all ticks while in cache:
+/// every tick invalidates one more radius of the halo, so the computed region shrinks by one radius per tick down to the tile itself.
+/// Blocks only see the cortex' real borders where the tile is close to them, so their other borders only ever affect the halo.
+/// @param blocks One block per thread, large enough for the cortex' tiles and their halo.
+static void c2d_tick_blocked(
+    bhm_cortex2d_t* prev_cortex,
+    bhm_cortex2d_t* next_cortex,
+    bhm_ticks_count_t depth,
+    bhm_tile_block_t* blocks
+) {
+    bhm_nh_stencil_t stencil;
+    nh_stencil_init(&stencil, prev_cortex);
+
+    bhm_rand_jump_t rand_jump;
+    bhm_bool_t jump_rand = prev_cortex->rand_mode == BHM_RAND_MODE_CONTINUOUS;
+    if (jump_rand) {
+        rand_jump_init(&rand_jump, stencil.count);
+    }
+
+    bhm_bool_t simd = BHM_FALSE;
+#ifdef __BHM_X86__
+    simd = prev_cortex->storage_mode == BHM_STORAGE_MODE_SOA &&
+        prev_cortex->tick_mode == BHM_TICK_MODE_SIMD &&
+        prev_cortex->integration_mode == BHM_INTEGRATION_MODE_SEQUENTIAL &&
+        (__builtin_cpu_supports("avx512f") || __builtin_cpu_supports("avx2"));
+#endif
+
+    // Static state doesn't change outside of evolution ticks, so it's only written back if the cortices don't already share it.
+    bhm_bool_t write_static = !(prev_cortex->storage_mode == BHM_STORAGE_MODE_SOA && soa_shares_static(&(prev_cortex->soa), &(next_cortex->soa)));
+
+    bhm_cortex_size_t halo = depth * prev_cortex->nh_radius;
+    bhm_cortex_size_t tiles_width, tiles_height;
+    c2d_tiles_count(prev_cortex, &tiles_width, &tiles_height);
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (bhm_cortex_size_t ty = 0; ty < tiles_height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < tiles_width; tx++) {
+#ifdef _OPENMP
+            bhm_tile_block_t* block = &(blocks[omp_get_thread_num()]);
+#else
+            bhm_tile_block_t* block = &(blocks[0]);
+#endif
+
+            bhm_cortex_size_t x0, y0, x1, y1;
+            c2d_tile_bounds(prev_cortex, tx, ty, &x0, &y0, &x1, &y1);
+
+            // Bounds of the tile and its halo, clipped to the cortex.
+            bhm_cortex_size_t hx0 = x0 - halo > 0 ? x0 - halo : 0;
+            bhm_cortex_size_t hy0 = y0 - halo > 0 ? y0 - halo : 0;
+            bhm_cortex_size_t hx1 = x1 + halo < prev_cortex->width ? x1 + halo : prev_cortex->width;
+            bhm_cortex_size_t hy1 = y1 + halo < prev_cortex->height ? y1 + halo : prev_cortex->height;
+            bhm_cortex_size_t block_width = hx1 - hx0;
+            bhm_cortex_size_t block_height = hy1 - hy0;
+
+            for (int i = 0; i < 2; i++) {
+                block->cortices[i].width = block_width;
+                block->cortices[i].height = block_height;
+            }
+
+            // Load the tile and its halo, along with their fired bits.
+            bhm_cortex2d_t* block_prev = &(block->cortices[0]);
+            for (bhm_cortex_size_t y = 0; y < block_height; y++) {
+                c2d_copy_span(block_prev, IDX2D(0, y, block_width), prev_cortex, IDX2D(hx0, hy0 + y, prev_cortex->width), block_width, BHM_TRUE);
+                c2d_publish_fired_span(block_prev, y, 0, block_width);
+            }
 
-                    // Shift the masks to check for the next neighbor.
-                    prev_ac_mask >>= 0x01U;
-                    prev_exc_mask >>= 0x01U;
-                    prev_str_mask_a >>= 0x01U;
-                    prev_str_mask_b >>= 0x01U;
-                    prev_str_mask_c >>= 0x01U;
+            for (bhm_ticks_count_t t = 0; t < depth; t++) {
+                block_prev = &(block->cortices[t % 2]);
+                bhm_cortex2d_t* block_next = &(block->cortices[(t + 1) % 2]);
+                block_prev->ticks_count = prev_cortex->ticks_count + t;
+
+                // Only the part of the halo still needed by later ticks is computed.
+                bhm_cortex_size_t margin = (depth - t - 1) * prev_cortex->nh_radius;
+                bhm_cortex_size_t rx0 = x0 - hx0 - margin > 0 ? x0 - hx0 - margin : 0;
+                bhm_cortex_size_t ry0 = y0 - hy0 - margin > 0 ? y0 - hy0 - margin : 0;
+                bhm_cortex_size_t rx1 = x1 - hx0 + margin < block_width ? x1 - hx0 + margin : block_width;
+                bhm_cortex_size_t ry1 = y1 - hy0 + margin < block_height ? y1 - hy0 + margin : block_height;
+
+                for (bhm_cortex_size_t y = ry0; y < ry1; y++) {
+                    c2d_tick_block_span(block_prev, block_next, y, rx0, rx1, &stencil, jump_rand ? &rand_jump : NULL, simd);
+
+                    // Neurons past the computed part are stale, so their fired bits are left alone: later ticks never read them.
+                    c2d_publish_fired_span(block_next, y, rx0, rx1);
                 }
             }
 
-            // Push to equilibrium by decaying to zero, both from above and below.
-            if (prev_neuron.value > 0x00) {
-                next_neuron->value -= next_cortex->decay_value;
-            } else if (prev_neuron.value < 0x00) {
-                next_neuron->value += next_cortex->decay_value;
+            // Write the tile back.
+            bhm_cortex2d_t* block_result = &(block->cortices[depth % 2]);
+            for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                c2d_copy_span(
+                    next_cortex,
+                    IDX2D(x0, y, next_cortex->width),
+                    block_result,
+                    IDX2D(x0 - hx0, y - hy0, block_width),
+                    x1 - x0,
+                    write_static
+                );
+                c2d_publish_fired_span(next_cortex, y, x0, x1);
+            }
+        }
+    }
+
+    next_cortex->fired.valid = BHM_TRUE;
+    next_cortex->fired.ghosts_valid = BHM_FALSE;
+
+    // Blocked ticks don't track activity, and the next cortex no longer holds the state of the previous one.
+    if (c2d_events_enabled(prev_cortex)) {
+        c2d_scan_events(next_cortex);
+    } else {
+        next_cortex->events.valid = BHM_FALSE;
+    }
+    next_cortex->events.version++;
+    next_cortex->events.source = NULL;
+
+    next_cortex->ticks_count = prev_cortex->ticks_count + depth;
+}
+
+bhm_error_code_t c2d_tick_n(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex, bhm_ticks_count_t ticks) {
+    if (ticks == 0) {
+        return BHM_ERROR_NONE;
+    }
+
+    // Halos grow by one radius per blocked tick, so the amount of ticks per pass is capped to keep them within a quarter of the tiles' size,
+    // which keeps the redundant work on halos reasonable.
+    bhm_cortex_size_t tile_side = prev_cortex->tile_width < prev_cortex->tile_height ? prev_cortex->tile_width : prev_cortex->tile_height;
+    bhm_ticks_count_t max_depth = tile_side / (4 * prev_cortex->nh_radius);
+    if (max_depth < 1) {
+        max_depth = 1;
+    }
+
+    // Halos are clipped to the cortex, so tiles close to the edges of a torus cortex would miss the neurons wrapping around,
+    // while blocks are copied in and out row by row, which needs rows to be contiguous: either way ticks are run one by one.
+    // Neither can be ticked in place either.
+    bhm_bool_t stepwise = prev_cortex->boundary_mode == BHM_BOUNDARY_MODE_TORUS || prev_cortex->layout != BHM_LAYOUT_ROW_MAJOR;
+    if (stepwise) {
+        max_depth = 1;
+    }
+
+    // Plan passes: evolution ticks change synapses, so they're run alone, while runs of other ticks are split in blocked passes.
+    bhm_ticks_count_t* depths = (bhm_ticks_count_t*) malloc((ticks + 1) * sizeof(bhm_ticks_count_t));
+    if (depths == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    bhm_ticks_count_t passes_count = 0;
+    bhm_ticks_count_t deepest = 1;
+    for (bhm_ticks_count_t t = 0; t < ticks;) {
+        bhm_ticks_count_t depth = 1;
+        if (!c2d_evolves_at(prev_cortex, prev_cortex->ticks_count + t)) {
+            while (depth < max_depth && t + depth < ticks && !c2d_evolves_at(prev_cortex, prev_cortex->ticks_count + t + depth)) {
+                depth++;
             }
+        }
+        depths[passes_count++] = depth;
+        deepest = depth > deepest ? depth : deepest;
+        t += depth;
+    }
+
+    // Passes alternate between the two cortices, so an odd amount of them is needed for the result to land in the next cortex.
+    // Splitting a blocked pass fixes that, otherwise the first tick is run in place, or copied back to the previous cortex if ticked one by one.
+    bhm_bool_t first_inplace = BHM_FALSE;
+    if (passes_count % 2 == 0) {
+        bhm_ticks_count_t split = 0;
+        while (split < passes_count && depths[split] < 2) {
+            split++;
+        }
 
-            if ((prev_neuron.pulse_mask >> prev_cortex->pulse_window) & 0x01U) {
-                // Decrease pulse if the oldest recorded pulse is active.
-                next_neuron->pulse--;
+        if (split < passes_count) {
+            memmove(&(depths[split + 1]), &(depths[split]), (passes_count - split) * sizeof(bhm_ticks_count_t));
+            depths[split]--;
+            depths[split + 1] = 1;
+            passes_count++;
+        } else {
+            first_inplace = BHM_TRUE;
+        }
+    }
+
+    // Allocate one block per thread, large enough for the deepest pass.
+#ifdef _OPENMP
+    int blocks_count = omp_get_max_threads();
+#else
+    int blocks_count = 1;
+#endif
+    bhm_tile_block_t* blocks = NULL;
+    bhm_error_code_t error = BHM_ERROR_NONE;
+    if (deepest > 1) {
+        bhm_cortex_size_t halo = deepest * prev_cortex->nh_radius;
+        blocks = (bhm_tile_block_t*) calloc(blocks_count, sizeof(bhm_tile_block_t));
+        error = blocks == NULL ? BHM_ERROR_FAILED_ALLOC : BHM_ERROR_NONE;
+        for (int b = 0; b < blocks_count && error == BHM_ERROR_NONE; b++) {
+            error = tile_block_alloc(&(blocks[b]), prev_cortex, prev_cortex->tile_width + 2 * halo, prev_cortex->tile_height + 2 * halo);
+        }
+    }
+
+    bhm_cortex2d_t* current = prev_cortex;
+    bhm_cortex2d_t* other = next_cortex;
+    for (bhm_ticks_count_t p = 0; p < passes_count && error == BHM_ERROR_NONE; p++) {
+        if (p == 0 && first_inplace) {
+            if (stepwise) {
+                c2d_tick(current, other);
+                other->ticks_count = current->ticks_count + 1;
+                error = c2d_copy(current, other);
+            } else {
+                error = c2d_tick_inplace(current);
             }
+            continue;
+        }
+
+        if (depths[p] > 1) {
+            c2d_tick_blocked(current, other, depths[p], blocks);
+        } else {
+            c2d_tick(current, other);
+            other->ticks_count = current->ticks_count + 1;
+        }
+
+        bhm_cortex2d_t* updated = other;
+        other = current;
+        current = updated;
+    }
+
+    if (blocks != NULL) {
+        for (int b = 0; b < blocks_count; b++) {
+            tile_block_free(&(blocks[b]));
+        }
+        free(blocks);
+    }
+    free(depths);
+
+    return error;
+}
 
-            next_neuron->pulse_mask <<= 0x01U;
+bhm_error_code_t bhm_pin_threads(const uint32_t* cores, uint32_t cores_count) {
+#ifdef __linux__
+    if (cores != NULL && cores_count == 0) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    // Gather the cores the process is allowed to run on.
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+        return BHM_ERROR_EXTERNAL_CAUSES;
+    }
+    int allowed_count = CPU_COUNT(&allowed);
+
+    bhm_bool_t failed = BHM_FALSE;
 
-            // Bring the neuron back to recovery if it just fired, otherwise fire it if its value is over its threshold.
-            if (prev_neuron.value > prev_cortex->fire_threshold + prev_neuron.pulse) {
-                // Fired at the previous step.
-                next_neuron->value = next_cortex->recovery_value;
+    #pragma omp parallel
+    {
+#ifdef _OPENMP
+        int thread = omp_get_thread_num();
+#else
+        int thread = 0;
+#endif
 
-                // Store pulse.
-                next_neuron->pulse_mask |= 0x01U;
-                next_neuron->pulse++;
+        int core = -1;
+        if (cores != NULL) {
+            core = cores[thread % cores_count];
+        } else {
+            // Look for the i-th allowed core.
+            for (int cpu = 0, seen = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed) && seen++ == thread % allowed_count) {
+                    core = cpu;
+                    break;
+                }
             }
         }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (core >= 0 && core < CPU_SETSIZE) {
+            CPU_SET(core, &set);
+        }
+
+        // Pin the calling thread.
+        if (core < 0 || core >= CPU_SETSIZE || sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+            #pragma omp atomic write
+            failed = BHM_TRUE;
+        }
+    }
+
+    return failed ? BHM_ERROR_EXTERNAL_CAUSES : BHM_ERROR_NONE;
+#else
+    return BHM_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+
+// ########################################## Partitioned cortex ##########################################
+
+bhm_error_code_t s2d_tick(bhm_slab2d_t* prev_slab, bhm_slab2d_t* next_slab) {
+    if (prev_slab->y0 != next_slab->y0 || prev_slab->y1 != next_slab->y1 || prev_slab->width != next_slab->width) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+    if (prev_slab->cortex->storage_mode != next_slab->cortex->storage_mode) {
+        return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+
+    // Neighbors' edges must be up to date before owned rows next to them are ticked.
+    bhm_error_code_t error = s2d_exchange_halos(prev_slab);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    // Halo rows are ticked along with owned ones, but they're replaced by the next exchange anyway.
+    c2d_tick(prev_slab->cortex, next_slab->cortex);
+
+    return BHM_ERROR_NONE;
+}
+
+void s2d_feed2d(bhm_slab2d_t* slab, bhm_input2d_t* input) {
+    bhm_cortex_size_t from = input->y0 > slab->y0 ? input->y0 : slab->y0;
+    bhm_cortex_size_t to = input->y1 < slab->y1 ? input->y1 : slab->y1;
+    if (from >= to) {
+        return;
+    }
+
+    // Feed owned rows only, translated to the slab's cortex.
+    bhm_input2d_t local_input = *input;
+    local_input.y0 = from - slab->y0 + slab->halo_top;
+    local_input.y1 = to - slab->y0 + slab->halo_top;
+    local_input.values = input->values + (from - input->y0) * (input->x1 - input->x0);
+
+    c2d_feed2d(slab->cortex, &local_input);
+}
+
+void s2d_read2d(bhm_slab2d_t* slab, bhm_output2d_t* output) {
+    bhm_cortex_size_t from = output->y0 > slab->y0 ? output->y0 : slab->y0;
+    bhm_cortex_size_t to = output->y1 < slab->y1 ? output->y1 : slab->y1;
+    if (from >= to) {
+        return;
+    }
+
+    // Read owned rows only, translated to the slab's cortex.
+    bhm_output2d_t local_output = *output;
+    local_output.y0 = from - slab->y0 + slab->halo_top;
+    local_output.y1 = to - slab->y0 + slab->halo_top;
+    local_output.values = output->values + (from - output->y0) * (output->x1 - output->x0);
+
+    c2d_read2d(slab->cortex, &local_output);
+}
+
+
+// ########################################## Simulation ##########################################
+
+/// @brief Swaps the cortices of the provided simulation, once the latest state has been ticked into its next cortex.
+static inline void sim2d_swap(bhm_sim2d_t* sim) {
+    bhm_cortex2d_t* latest = sim->next_cortex;
+    sim->next_cortex = sim->prev_cortex;
+    sim->prev_cortex = latest;
+}
+
+bhm_error_code_t sim2d_step(bhm_sim2d_t* sim, bhm_input2d_t* const* inputs, bhm_cortex_size_t inputs_count, bhm_output2d_t* const* outputs, bhm_cortex_size_t outputs_count) {
+    bhm_error_code_t error = c2d_step(sim->prev_cortex, sim->next_cortex, inputs, inputs_count, outputs, outputs_count);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    sim2d_swap(sim);
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t sim2d_run(bhm_sim2d_t* sim, bhm_ticks_count_t ticks, bhm_tick_hook_t hook, void* hook_data) {
+    bhm_error_code_t error = c2d_run(sim->prev_cortex, sim->next_cortex, ticks, hook, hook_data);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    // The latest state ends up in the next cortex after an odd amount of ticks only.
+    if (ticks % 2) {
+        sim2d_swap(sim);
     }
 
-    next_cortex->ticks_count++;
+    return BHM_ERROR_NONE;
 }
 
 
@@ -336,6 +3258,26 @@ bhm_bool_t value_to_pulse_rprop(bhm_ticks_count_t sample_window, bhm_ticks_count
 }
 
 bhm_bool_t value_to_pulse_dfprop(bhm_ticks_count_t sample_window, bhm_ticks_count_t sample_step, bhm_ticks_count_t input) {
-    // TODO
-    return BHM_FALSE;
+    bhm_ticks_count_t upper = sample_window - 1;
+
+    // sample_window = 10;
+    // upper = sample_window - 1 = 9;
+    // x = input;
+    // |@| | | | | | | | | | -> x = 0;
+    // |@| | | | | | | | |@| -> x = 1;
+    // |@| | | | |@| | | |@| -> x = 2;
+    // |@| | |@| | |@| | |@| -> x = 3;
+    // |@| | |@| |@| |@| |@| -> x = 4;
+    // | | |@| |@| |@| |@|@| -> x = 5;
+    // | | |@|@| |@|@| |@|@| -> x = 6;
+    // | | |@|@|@| |@|@|@|@| -> x = 7;
+    // | | |@|@|@|@|@|@|@|@| -> x = 8;
+    // | |@|@|@|@|@|@|@|@|@| -> x = 9;
+    if (sample_step <= 0) {
+        // Like the other proportional mappings, the first step only spikes for the lower half of inputs.
+        return input < sample_window / 2;
+    }
+
+    // Exactly [input] spikes are spread over the remaining [upper] steps, at the steps where the floored proportion of elapsed steps grows.
+    return (sample_step * input) / upper > ((sample_step - 1) * input) / upper;
 }
\ No newline at end of file
@@ -17,6 +17,9 @@ Copyright (C) 2021 Luka Micheletti
 #include <string.h>
 #include <math.h>
 #include "cortex.h"
+#include "population.h"
+#include "partition.h"
+#include "simulation.h"
 #include "error.h"
 #include "utils.h"
 
@@ -26,7 +29,15 @@ extern "C" {
 
 // ########################################## Execution functions ##########################################
 
+/// @brief Hook called by c2d_run before each tick, to feed inputs to and read outputs from the cortex.
+/// @param cortex The cortex about to be ticked, holding the outcome of the previous tick.
+/// @param tick The index of the tick about to be run, starting from 0 at each c2d_run call.
+/// @param data The data provided to c2d_run.
+typedef void (*bhm_tick_hook_t)(bhm_cortex2d_t* cortex, bhm_ticks_count_t tick, void* data);
+
 /// @brief Feeds a cortex through the provided input2d. Input data should already be in the provided input2d by the time this function is called.
+/// Spikes are looked up from a schedule of each input's spikes over the cortex' sample window, computed through value_to_pulse
+/// the first time each pulse mapping and sample window are fed.
 /// @param cortex The cortex to feed.
 /// @param input The input to feed the cortex.
 void c2d_feed2d(bhm_cortex2d_t* cortex, bhm_input2d_t* input);
@@ -42,6 +53,117 @@ void c2d_read2d(bhm_cortex2d_t* cortex, bhm_output2d_t* output);
 /// @warning prev_cortex and next_cortex should contain the same data (aka be copies one of the other), otherwise this operation may lead to unexpected behavior.
 void c2d_tick(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex);
 
+/// @brief Performs [ticks] run cycles, alternating the two provided cortices exactly like as many calls to c2d_tick with swapped arguments would:
+/// even ticks go from [prev_cortex] to [next_cortex] and odd ones back. The latest state is then in [next_cortex] after an odd amount of ticks
+/// and in [prev_cortex] after an even one.
+/// All ticks run in a single parallel region instead of one per call, which makes a difference on small cortices, where forking
+/// and joining threads takes as long as the tick itself.
+/// @param prev_cortex The cortex at its current state.
+/// @param next_cortex The cortex updated by the first tick, which should contain the same data as [prev_cortex] (see c2d_tick).
+/// @param ticks The amount of ticks to run.
+/// @param hook The function to call before each tick, from a single thread while all others wait, may be NULL. Library functions
+/// called from it, such as c2d_feed2d and c2d_read2d, run on that thread alone unless nested parallelism is enabled.
+/// @param hook_data Data to pass to [hook] on each call.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_run(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex, bhm_ticks_count_t ticks, bhm_tick_hook_t hook, void* hook_data);
+
+/// @brief Performs a full run cycle over each of the provided pairs of independent cortices, with the same results as calling c2d_tick on each pair.
+/// All pairs are ticked in a single parallel region: cortices with at least BHM_BATCH_SHARED_TILES tiles per thread are ticked by the
+/// whole team, one after the other, while smaller ones are each ticked by a single thread, as many at once as there are threads.
+/// @param prev_cortices The cortices at their current state.
+/// @param next_cortices The cortices that will be updated by the tick cycle, each paired with the one at the same index in [prev_cortices].
+/// @param count The amount of pairs.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none. Nothing is ticked on error.
+bhm_error_code_t c2d_tick_batch(bhm_cortex2d_t* const* prev_cortices, bhm_cortex2d_t* const* next_cortices, bhm_cortex_size_t count);
+
+/// @brief Performs a full step over the provided cortex: feeds all inputs to [prev_cortex], ticks it into [next_cortex] and reads all outputs
+/// from [next_cortex], with the same results as calling c2d_feed2d, c2d_tick and c2d_read2d in this order, but in a single parallel region.
+/// Outputs are read from each row as soon as the tick writes it, instead of in a separate pass over the cortex.
+/// @param prev_cortex The cortex at its current state, which receives inputs.
+/// @param next_cortex The cortex that will be updated by the tick cycle, which outputs are read from.
+/// @param inputs The inputs to feed, in order.
+/// @param inputs_count The amount of inputs in [inputs].
+/// @param outputs The outputs to read.
+/// @param outputs_count The amount of outputs in [outputs].
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_step(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex, bhm_input2d_t* const* inputs, bhm_cortex_size_t inputs_count, bhm_output2d_t* const* outputs, bhm_cortex_size_t outputs_count);
+
+/// @brief Performs a full run cycle over the provided cortex, updating it in place, with the same results as c2d_tick.
+/// Rows are split into one band per thread: each band sets aside the rows it reads across its borders before the tick starts,
+/// then keeps a rolling window of the previous state of the last few rows it updated, so that all neurons still see the previous tick.
+/// Event-driven tick mode falls back to full ticks, since skipping tiles relies on a second cortex.
+/// Unlike alternating two cortices, the ticks count of the cortex advances by exactly one per tick.
+/// @param cortex The cortex to update.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_NOT_SUPPORTED] if the cortex is in torus boundary mode
+/// or in brick layout.
+bhm_error_code_t c2d_tick_inplace(bhm_cortex2d_t* cortex);
+
+/// @brief Performs [ticks] run cycles over the provided cortex, with the same results as as many calls to c2d_tick_inplace.
+/// Runs of non-evolution ticks are temporally blocked: each tile is advanced by several ticks at once while in cache, along with a halo
+/// of neighbors as wide as the neighborhood radius times the amount of ticks, so the whole cortex is only streamed through memory once per run.
+/// Larger tiles allow more ticks per pass, at the cost of more cache per thread (see c2d_set_tile_size).
+/// Cortices in torus boundary mode are never blocked, since halos don't wrap around their edges, and neither are cortices in brick layout,
+/// since blocks are copied row by row: each tick is a full one.
+/// @param prev_cortex The cortex at its current state. It's used as scratch, so it holds some intermediate state after the call.
+/// @param next_cortex The cortex that will hold the updated state.
+/// @param ticks The amount of ticks to run, nothing is done if 0.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_tick_n(bhm_cortex2d_t* prev_cortex, bhm_cortex2d_t* next_cortex, bhm_ticks_count_t ticks);
+
+/// @brief Ticks all cortices of the provided ensemble at once, each lane behaving as if its cortex was ticked by c2d_tick_inplace.
+/// Like in-place ticks, the ticks count of each lane advances by exactly one per tick, so evolution doesn't happen on the same ticks
+/// as when alternating two cortices with c2d_tick.
+/// Ticks that evolve no lane and only integrate sequentially update all lanes of each neuron side by side, one vector lane per cortex,
+/// while any other tick updates lanes one by one.
+/// @param ensemble The ensemble to tick.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t e2d_tick(bhm_ensemble2d_t* ensemble);
+
+/// @brief Performs a full run cycle over the provided slabs of a partitioned cortex, with the same results on owned rows as c2d_tick
+/// on the whole cortex. Halos of [prev_slab] are exchanged first, so all processes sharing the transport must tick at once.
+/// @param prev_slab The slab at its current state.
+/// @param next_slab The slab that will be updated by the tick cycle, owning the same rows as [prev_slab].
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t s2d_tick(bhm_slab2d_t* prev_slab, bhm_slab2d_t* next_slab);
+
+/// @brief Feeds the rows of the provided input2d owned by the slab, given in whole cortex coordinates. Other rows are left to their owners.
+/// @param slab The slab to feed.
+/// @param input The input to feed the partitioned cortex.
+void s2d_feed2d(bhm_slab2d_t* slab, bhm_input2d_t* input);
+
+/// @brief Reads the rows of the provided output2d owned by the slab, given in whole cortex coordinates. Other rows are left untouched.
+/// @param slab The slab to read values from.
+/// @param output The output used to read data from the partitioned cortex.
+void s2d_read2d(bhm_slab2d_t* slab, bhm_output2d_t* output);
+
+/// @brief Performs a full step over the provided simulation, just like c2d_step over its cortices, then swaps them
+/// so that the updated state is found in sim2d_cortex.
+/// @param sim The simulation to step.
+/// @param inputs The inputs to feed, in order.
+/// @param inputs_count The amount of inputs in [inputs].
+/// @param outputs The outputs to read, from the updated state.
+/// @param outputs_count The amount of outputs in [outputs].
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t sim2d_step(bhm_sim2d_t* sim, bhm_input2d_t* const* inputs, bhm_cortex_size_t inputs_count, bhm_output2d_t* const* outputs, bhm_cortex_size_t outputs_count);
+
+/// @brief Performs [ticks] run cycles over the provided simulation, just like c2d_run over its cortices, leaving the latest state in sim2d_cortex.
+/// @param sim The simulation to run.
+/// @param ticks The amount of ticks to run.
+/// @param hook The function to call before each tick, see c2d_run, may be NULL.
+/// @param hook_data Data to pass to [hook] on each call.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t sim2d_run(bhm_sim2d_t* sim, bhm_ticks_count_t ticks, bhm_tick_hook_t hook, void* hook_data);
+
+/// @brief Pins each thread of the OpenMP team to a single core, so that threads keep ticking the tiles whose memory they first touched.
+/// Should be called before creating cortices, and the amount of threads should not change afterwards, otherwise the partition of tiles among
+/// threads no longer matches the one used when neurons were first touched (see c2d_set_numa_policy).
+/// @param cores The cores to pin threads to, the i-th thread being pinned to cores[i % cores_count]. If NULL, the i-th thread is pinned to the
+/// i-th core the process is allowed to run on.
+/// @param cores_count The amount of cores in [cores], ignored if [cores] is NULL.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_NOT_SUPPORTED] if thread affinity is not available on the
+/// current platform.
+bhm_error_code_t bhm_pin_threads(const uint32_t* cores, uint32_t cores_count);
+
 
 // ########################################## Input mapping functions ##########################################
 
@@ -75,6 +197,12 @@ bhm_bool_t value_to_pulse_fprop(bhm_ticks_count_t sample_window, bhm_ticks_count
 /// @param input The actual input to map to a pulse (must be in range 0..sample_window).
 bhm_bool_t value_to_pulse_rprop(bhm_ticks_count_t sample_window, bhm_ticks_count_t sample_step, bhm_ticks_count_t input);
 
+/// @brief Computes a double floored proportional mapping for the given input and sample step.
+/// Spreads exactly [input] spikes as evenly as integer divisions allow over all steps but the first, which only spikes for the lower half of inputs.
+/// It's as cheap as fprop, but its distribution is even on any window.
+/// @param sample_window The width of the sampling window.
+/// @param sample_step The step to test inside the specified window (e.g. w=10 s=3 => | | | |X| | | | | | |).
+/// @param input The actual input to map to a pulse (must be in range 0..sample_window).
 bhm_bool_t value_to_pulse_dfprop(bhm_ticks_count_t sample_window, bhm_ticks_count_t sample_step, bhm_ticks_count_t input);
 
 
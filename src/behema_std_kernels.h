@@ -0,0 +1,186 @@
+/*
+*****************************************************************
+behema_std_kernels.h
+
+Copyright (C) 2021 Luka Micheletti
+*****************************************************************
+*/
+
+// Radius-specialized interior tick kernels, only meant to be included by behema_std.c.
+// Each kernel walks its neighborhood through a fully unrolled stencil, so that neighbor column offsets and synapse mask bits are compile-time constants.
+
+#ifndef __BEHEMA_STD_KERNELS__
+#define __BEHEMA_STD_KERNELS__
+
+// ########################################## Stencils ##########################################
+
+// Neighborhood stencils, listed row by row in synapse mask order with the central neuron excluded.
+// STEP is expanded once per neighbor as STEP(x offset, y offset, synapse mask bit).
+
+#define BHM_NH_STENCIL_R1(STEP) \
+    STEP(-1, -1, 0) STEP(0, -1, 1) STEP(1, -1, 2) \
+    STEP(-1, 0, 3) STEP(1, 0, 5) \
+    STEP(-1, 1, 6) STEP(0, 1, 7) STEP(1, 1, 8)
+
+#define BHM_NH_STENCIL_R2(STEP) \
+    STEP(-2, -2, 0) STEP(-1, -2, 1) STEP(0, -2, 2) STEP(1, -2, 3) STEP(2, -2, 4) \
+    STEP(-2, -1, 5) STEP(-1, -1, 6) STEP(0, -1, 7) STEP(1, -1, 8) STEP(2, -1, 9) \
+    STEP(-2, 0, 10) STEP(-1, 0, 11) STEP(1, 0, 13) STEP(2, 0, 14) \
+    STEP(-2, 1, 15) STEP(-1, 1, 16) STEP(0, 1, 17) STEP(1, 1, 18) STEP(2, 1, 19) \
+    STEP(-2, 2, 20) STEP(-1, 2, 21) STEP(0, 2, 22) STEP(1, 2, 23) STEP(2, 2, 24)
+
+#define BHM_NH_STENCIL_R3(STEP) \
+    STEP(-3, -3, 0) STEP(-2, -3, 1) STEP(-1, -3, 2) STEP(0, -3, 3) STEP(1, -3, 4) STEP(2, -3, 5) STEP(3, -3, 6) \
+    STEP(-3, -2, 7) STEP(-2, -2, 8) STEP(-1, -2, 9) STEP(0, -2, 10) STEP(1, -2, 11) STEP(2, -2, 12) STEP(3, -2, 13) \
+    STEP(-3, -1, 14) STEP(-2, -1, 15) STEP(-1, -1, 16) STEP(0, -1, 17) STEP(1, -1, 18) STEP(2, -1, 19) STEP(3, -1, 20) \
+    STEP(-3, 0, 21) STEP(-2, 0, 22) STEP(-1, 0, 23) STEP(1, 0, 25) STEP(2, 0, 26) STEP(3, 0, 27) \
+    STEP(-3, 1, 28) STEP(-2, 1, 29) STEP(-1, 1, 30) STEP(0, 1, 31) STEP(1, 1, 32) STEP(2, 1, 33) STEP(3, 1, 34) \
+    STEP(-3, 2, 35) STEP(-2, 2, 36) STEP(-1, 2, 37) STEP(0, 2, 38) STEP(1, 2, 39) STEP(2, 2, 40) STEP(3, 2, 41) \
+    STEP(-3, 3, 42) STEP(-2, 3, 43) STEP(-1, 3, 44) STEP(0, 3, 45) STEP(1, 3, 46) STEP(2, 3, 47) STEP(3, 3, 48)
+
+// Radii 4 and 5 only fit in 16 bytes masks.
+#ifdef BHM_WIDE_NH
+
+#define BHM_NH_STENCIL_R4(STEP) \
+    STEP(-4, -4, 0) STEP(-3, -4, 1) STEP(-2, -4, 2) STEP(-1, -4, 3) STEP(0, -4, 4) STEP(1, -4, 5) STEP(2, -4, 6) STEP(3, -4, 7) STEP(4, -4, 8) \
+    STEP(-4, -3, 9) STEP(-3, -3, 10) STEP(-2, -3, 11) STEP(-1, -3, 12) STEP(0, -3, 13) STEP(1, -3, 14) STEP(2, -3, 15) STEP(3, -3, 16) STEP(4, -3, 17) \
+    STEP(-4, -2, 18) STEP(-3, -2, 19) STEP(-2, -2, 20) STEP(-1, -2, 21) STEP(0, -2, 22) STEP(1, -2, 23) STEP(2, -2, 24) STEP(3, -2, 25) STEP(4, -2, 26) \
+    STEP(-4, -1, 27) STEP(-3, -1, 28) STEP(-2, -1, 29) STEP(-1, -1, 30) STEP(0, -1, 31) STEP(1, -1, 32) STEP(2, -1, 33) STEP(3, -1, 34) STEP(4, -1, 35) \
+    STEP(-4, 0, 36) STEP(-3, 0, 37) STEP(-2, 0, 38) STEP(-1, 0, 39) STEP(1, 0, 41) STEP(2, 0, 42) STEP(3, 0, 43) STEP(4, 0, 44) \
+    STEP(-4, 1, 45) STEP(-3, 1, 46) STEP(-2, 1, 47) STEP(-1, 1, 48) STEP(0, 1, 49) STEP(1, 1, 50) STEP(2, 1, 51) STEP(3, 1, 52) STEP(4, 1, 53) \
+    STEP(-4, 2, 54) STEP(-3, 2, 55) STEP(-2, 2, 56) STEP(-1, 2, 57) STEP(0, 2, 58) STEP(1, 2, 59) STEP(2, 2, 60) STEP(3, 2, 61) STEP(4, 2, 62) \
+    STEP(-4, 3, 63) STEP(-3, 3, 64) STEP(-2, 3, 65) STEP(-1, 3, 66) STEP(0, 3, 67) STEP(1, 3, 68) STEP(2, 3, 69) STEP(3, 3, 70) STEP(4, 3, 71) \
+    STEP(-4, 4, 72) STEP(-3, 4, 73) STEP(-2, 4, 74) STEP(-1, 4, 75) STEP(0, 4, 76) STEP(1, 4, 77) STEP(2, 4, 78) STEP(3, 4, 79) STEP(4, 4, 80)
+
+#define BHM_NH_STENCIL_R5(STEP) \
+    STEP(-5, -5, 0) STEP(-4, -5, 1) STEP(-3, -5, 2) STEP(-2, -5, 3) STEP(-1, -5, 4) STEP(0, -5, 5) STEP(1, -5, 6) STEP(2, -5, 7) STEP(3, -5, 8) STEP(4, -5, 9) STEP(5, -5, 10) \
+    STEP(-5, -4, 11) STEP(-4, -4, 12) STEP(-3, -4, 13) STEP(-2, -4, 14) STEP(-1, -4, 15) STEP(0, -4, 16) STEP(1, -4, 17) STEP(2, -4, 18) STEP(3, -4, 19) STEP(4, -4, 20) STEP(5, -4, 21) \
+    STEP(-5, -3, 22) STEP(-4, -3, 23) STEP(-3, -3, 24) STEP(-2, -3, 25) STEP(-1, -3, 26) STEP(0, -3, 27) STEP(1, -3, 28) STEP(2, -3, 29) STEP(3, -3, 30) STEP(4, -3, 31) STEP(5, -3, 32) \
+    STEP(-5, -2, 33) STEP(-4, -2, 34) STEP(-3, -2, 35) STEP(-2, -2, 36) STEP(-1, -2, 37) STEP(0, -2, 38) STEP(1, -2, 39) STEP(2, -2, 40) STEP(3, -2, 41) STEP(4, -2, 42) STEP(5, -2, 43) \
+    STEP(-5, -1, 44) STEP(-4, -1, 45) STEP(-3, -1, 46) STEP(-2, -1, 47) STEP(-1, -1, 48) STEP(0, -1, 49) STEP(1, -1, 50) STEP(2, -1, 51) STEP(3, -1, 52) STEP(4, -1, 53) STEP(5, -1, 54) \
+    STEP(-5, 0, 55) STEP(-4, 0, 56) STEP(-3, 0, 57) STEP(-2, 0, 58) STEP(-1, 0, 59) STEP(1, 0, 61) STEP(2, 0, 62) STEP(3, 0, 63) STEP(4, 0, 64) STEP(5, 0, 65) \
+    STEP(-5, 1, 66) STEP(-4, 1, 67) STEP(-3, 1, 68) STEP(-2, 1, 69) STEP(-1, 1, 70) STEP(0, 1, 71) STEP(1, 1, 72) STEP(2, 1, 73) STEP(3, 1, 74) STEP(4, 1, 75) STEP(5, 1, 76) \
+    STEP(-5, 2, 77) STEP(-4, 2, 78) STEP(-3, 2, 79) STEP(-2, 2, 80) STEP(-1, 2, 81) STEP(0, 2, 82) STEP(1, 2, 83) STEP(2, 2, 84) STEP(3, 2, 85) STEP(4, 2, 86) STEP(5, 2, 87) \
+    STEP(-5, 3, 88) STEP(-4, 3, 89) STEP(-3, 3, 90) STEP(-2, 3, 91) STEP(-1, 3, 92) STEP(0, 3, 93) STEP(1, 3, 94) STEP(2, 3, 95) STEP(3, 3, 96) STEP(4, 3, 97) STEP(5, 3, 98) \
+    STEP(-5, 4, 99) STEP(-4, 4, 100) STEP(-3, 4, 101) STEP(-2, 4, 102) STEP(-1, 4, 103) STEP(0, 4, 104) STEP(1, 4, 105) STEP(2, 4, 106) STEP(3, 4, 107) STEP(4, 4, 108) STEP(5, 4, 109) \
+    STEP(-5, 5, 110) STEP(-4, 5, 111) STEP(-3, 5, 112) STEP(-2, 5, 113) STEP(-1, 5, 114) STEP(0, 5, 115) STEP(1, 5, 116) STEP(2, 5, 117) STEP(3, 5, 118) STEP(4, 5, 119) STEP(5, 5, 120)
+
+#endif
+
+
+// ########################################## Kernels ##########################################
+
+#define BHM_AOS_STENCIL_STEP(DX, DY, BIT) \
+    n2d_tick_synapse( \
+        prev_cortex, \
+        next_cortex, \
+        &prev_neuron, \
+        next_neuron, \
+        neighbors[(DY) * width + (DX)].value, \
+        neighbors[(DY) * width + (DX)].pulse, \
+        BIT, \
+        evolve, \
+        counter_randoms, \
+        &fired_nh_mask \
+    );
+
+#define BHM_SOA_STENCIL_STEP(DX, DY, BIT) \
+    n2d_tick_synapse( \
+        prev_cortex, \
+        next_cortex, \
+        &prev_neuron, \
+        &next_neuron, \
+        neighbor_values[(DY) * width + (DX)], \
+        neighbor_pulses[(DY) * width + (DX)], \
+        BIT, \
+        evolve, \
+        counter_randoms, \
+        &fired_nh_mask \
+    );
+
+/// @brief Defines c2d_tick_aos_interior_row_r[R] and c2d_tick_soa_interior_row_r[R], which update the interior neurons from [row_index] + [x0]
+/// to [row_index] + [x1] of a cortex with neighborhood radius [R] in AOS and SOA storage mode respectively on an evolution tick.
+/// Both behave exactly like their stencil-driven counterparts in behema_std.c.
+#define BHM_DEFINE_INTERIOR_KERNELS(R) \
+static inline void c2d_tick_aos_interior_neuron_r##R( \
+    bhm_cortex2d_t* prev_cortex, \
+    bhm_cortex2d_t* next_cortex, \
+    bhm_cortex_size_t neuron_index, \
+    bhm_bool_t evolve \
+) { \
+    const bhm_cortex_size_t width = prev_cortex->width; \
+    bhm_neuron_t prev_neuron = prev_cortex->neurons[neuron_index]; \
+    bhm_neuron_t* next_neuron = &(next_cortex->neurons[neuron_index]); \
+    const bhm_neuron_t* neighbors = &(prev_cortex->neurons[neuron_index]); \
+    \
+    *next_neuron = prev_neuron; \
+    \
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8]; \
+    if (evolve && prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER) { \
+        c2d_counter_randoms(prev_cortex, neuron_index, prev_neuron.rand_state, counter_randoms); \
+    } \
+    \
+    bhm_nh_mask_t fired_nh_mask = 0x00U; \
+    BHM_NH_STENCIL_R##R(BHM_AOS_STENCIL_STEP) \
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) { \
+        next_neuron->value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask); \
+    } \
+    \
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, next_neuron); \
+} \
+\
+static inline void c2d_tick_soa_interior_neuron_r##R( \
+    bhm_cortex2d_t* prev_cortex, \
+    bhm_cortex2d_t* next_cortex, \
+    bhm_cortex_size_t neuron_index, \
+    bhm_bool_t evolve \
+) { \
+    const bhm_cortex_size_t width = prev_cortex->width; \
+    const bhm_neuron_value_t* neighbor_values = &(prev_cortex->soa.value[neuron_index]); \
+    const bhm_ticks_count_t* neighbor_pulses = &(prev_cortex->soa.pulse[neuron_index]); \
+    \
+    bhm_neuron_t prev_neuron; \
+    soa_load_neuron(&(prev_cortex->soa), neuron_index, &prev_neuron); \
+    bhm_neuron_t next_neuron = prev_neuron; \
+    \
+    bhm_rand_state_t counter_randoms[sizeof(bhm_nh_mask_t) * 8]; \
+    if (evolve && prev_cortex->rand_mode == BHM_RAND_MODE_COUNTER) { \
+        c2d_counter_randoms(prev_cortex, neuron_index, prev_neuron.rand_state, counter_randoms); \
+    } \
+    \
+    bhm_nh_mask_t fired_nh_mask = 0x00U; \
+    BHM_NH_STENCIL_R##R(BHM_SOA_STENCIL_STEP) \
+    if (prev_cortex->integration_mode == BHM_INTEGRATION_MODE_POPCOUNT) { \
+        next_neuron.value = n2d_popcount_integrated_value(prev_cortex, &prev_neuron, fired_nh_mask); \
+    } \
+    \
+    n2d_tick_epilogue(prev_cortex, next_cortex, &prev_neuron, &next_neuron); \
+    \
+    c2d_commit_soa_neuron(prev_cortex, next_cortex, neuron_index, &next_neuron, evolve); \
+} \
+\
+static void c2d_tick_aos_interior_row_r##R( \
+    bhm_cortex2d_t* prev_cortex, \
+    bhm_cortex2d_t* next_cortex, \
+    bhm_cortex_size_t row_index, \
+    bhm_cortex_size_t x0, \
+    bhm_cortex_size_t x1 \
+) { \
+    for (bhm_cortex_size_t x = x0; x < x1; x++) { \
+        c2d_tick_aos_interior_neuron_r##R(prev_cortex, next_cortex, row_index + x, BHM_TRUE); \
+    } \
+} \
+\
+static void c2d_tick_soa_interior_row_r##R( \
+    bhm_cortex2d_t* prev_cortex, \
+    bhm_cortex2d_t* next_cortex, \
+    bhm_cortex_size_t row_index, \
+    bhm_cortex_size_t x0, \
+    bhm_cortex_size_t x1 \
+) { \
+    for (bhm_cortex_size_t x = x0; x < x1; x++) { \
+        c2d_tick_soa_interior_neuron_r##R(prev_cortex, next_cortex, row_index + x, BHM_TRUE); \
+    } \
+}
+
+#endif
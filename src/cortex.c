@@ -1,15 +1,270 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef BHM_NUMA
+#include <sched.h>
+#include <numa.h>
+#include <numaif.h>
+#endif
+
 #include "cortex.h"
 
 // The state word must be initialized to non-zero.
 uint32_t xorshf32(
     uint32_t state
 ) {
-    // Algorithm "xor" from p. 4 of Marsaglia, "Xorshift RNGs".
-    uint32_t x = state;
-    x ^= x << 13;
-    x ^= x >> 17;
-    x ^= x << 5;
-    return x;
+    return xorshf32_inline(state);
+}
+
+#ifdef BHM_NUMA
+/// @brief Places [bytes] bytes of memory starting at [array] according to the provided NUMA policy.
+/// The array is laid out like the neurons of [cortex], with items of [item_size] bytes. If [move] is set, pages already in memory are moved
+/// as well, otherwise the policy only applies to pages touched from now on.
+static void numa_place_array(const bhm_cortex2d_t* cortex, bhm_numa_policy_t numa_policy, void* array, size_t item_size, bhm_bool_t move) {
+    uintptr_t page_size = (uintptr_t) numa_pagesize();
+    uintptr_t start = (uintptr_t) array & ~(page_size - 1);
+    uintptr_t end = ((uintptr_t) array + cortex->width * cortex->height * item_size + page_size - 1) & ~(page_size - 1);
+
+    if (numa_policy == BHM_NUMA_POLICY_INTERLEAVE) {
+        mbind((void*) start, end - start, MPOL_INTERLEAVE, numa_all_nodes_ptr->maskp, numa_all_nodes_ptr->size + 1, move ? MPOL_MF_MOVE : 0);
+        return;
+    }
+
+    // First touch is the default policy.
+    mbind((void*) start, end - start, MPOL_DEFAULT, NULL, 0, 0);
+    if (!move) {
+        return;
+    }
+
+    // Move each tile's pages to the node of the thread ticking it, as if they were touched by it first.
+    bhm_cortex_size_t tiles_width, tiles_height;
+    c2d_tiles_count(cortex, &tiles_width, &tiles_height);
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (bhm_cortex_size_t ty = 0; ty < tiles_height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < tiles_width; tx++) {
+            bhm_cortex_size_t x0, y0, x1, y1;
+            c2d_tile_bounds(cortex, tx, ty, &x0, &y0, &x1, &y1);
+
+            int node = numa_node_of_cpu(sched_getcpu());
+            void* pages[64];
+            int nodes[64];
+            int status[64];
+            unsigned long pages_count = 0;
+
+            for (bhm_cortex_size_t y = y0, y_last = y0; y < y1; y = y_last + 1) {
+                // In brick layout the tile's part of a whole band is contiguous, so it's placed at once.
+                y_last = y;
+                if (cortex->layout == BHM_LAYOUT_BRICK) {
+                    bhm_cortex_size_t band_end = y - y % BHM_BRICK_SIDE + BHM_BRICK_SIDE;
+                    y_last = (band_end < y1 ? band_end : y1) - 1;
+                }
+
+                uintptr_t first = ((uintptr_t) array + c2d_neuron_index(cortex, x0, y) * item_size) & ~(page_size - 1);
+                uintptr_t last = ((uintptr_t) array + (c2d_neuron_index(cortex, x1 - 1, y_last) + 1) * item_size - 1) & ~(page_size - 1);
+
+                for (uintptr_t page = first; page <= last; page += page_size) {
+                    // Rows narrower than a page share it with the previous row.
+                    if (pages_count > 0 && (uintptr_t) pages[pages_count - 1] == page) {
+                        continue;
+                    }
+
+                    pages[pages_count] = (void*) page;
+                    nodes[pages_count] = node;
+                    pages_count++;
+
+                    if (pages_count == 64) {
+                        move_pages(0, pages_count, pages, nodes, status, MPOL_MF_MOVE);
+                        pages_count = 0;
+                    }
+                }
+            }
+
+            if (pages_count > 0) {
+                move_pages(0, pages_count, pages, nodes, status, MPOL_MF_MOVE);
+            }
+        }
+    }
+}
+
+/// @brief Places all neuron storage of [cortex] in the provided layout according to the provided NUMA policy. See numa_place_array.
+static void numa_place_neurons(
+    const bhm_cortex2d_t* cortex,
+    bhm_numa_policy_t numa_policy,
+    bhm_storage_mode_t storage_mode,
+    bhm_neuron_t* neurons,
+    bhm_neurons_soa_t* soa,
+    bhm_bool_t move
+) {
+    if (storage_mode == BHM_STORAGE_MODE_AOS) {
+        numa_place_array(cortex, numa_policy, neurons, sizeof(bhm_neuron_t), move);
+        return;
+    }
+
+    numa_place_array(cortex, numa_policy, soa->synac_mask, sizeof(bhm_nh_mask_t), move);
+    numa_place_array(cortex, numa_policy, soa->synex_mask, sizeof(bhm_nh_mask_t), move);
+    numa_place_array(cortex, numa_policy, soa->synstr_mask_a, sizeof(bhm_nh_mask_t), move);
+    numa_place_array(cortex, numa_policy, soa->synstr_mask_b, sizeof(bhm_nh_mask_t), move);
+    numa_place_array(cortex, numa_policy, soa->synstr_mask_c, sizeof(bhm_nh_mask_t), move);
+    numa_place_array(cortex, numa_policy, soa->max_syn_count, sizeof(bhm_syn_count_t), move);
+    numa_place_array(cortex, numa_policy, soa->syn_count, sizeof(bhm_syn_count_t), move);
+    numa_place_array(cortex, numa_policy, soa->tot_syn_strength, sizeof(bhm_syn_strength_t), move);
+    numa_place_array(cortex, numa_policy, soa->inhexc_ratio, sizeof(bhm_chance_t), move);
+    numa_place_array(cortex, numa_policy, soa->rand_state, sizeof(bhm_rand_state_t), move);
+    numa_place_array(cortex, numa_policy, soa->pulse_mask, sizeof(bhm_pulse_mask_t), move);
+    numa_place_array(cortex, numa_policy, soa->pulse, sizeof(bhm_ticks_count_t), move);
+    numa_place_array(cortex, numa_policy, soa->value, sizeof(bhm_neuron_value_t), move);
+}
+#endif
+
+
+/// @brief Calls [visit] on all neurons of [cortex], sharing them among threads tile by tile in the same partition ticks use.
+/// Storage written this way is first touched by the thread that later ticks it, which places it on that thread's NUMA node
+/// under the first touch policy.
+static void c2d_visit_tiles(
+    bhm_cortex2d_t* cortex,
+    void (*visit)(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, void* data),
+    void* data
+) {
+    bhm_cortex_size_t tiles_width, tiles_height;
+    c2d_tiles_count(cortex, &tiles_width, &tiles_height);
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (bhm_cortex_size_t ty = 0; ty < tiles_height; ty++) {
+        for (bhm_cortex_size_t tx = 0; tx < tiles_width; tx++) {
+            bhm_cortex_size_t x0, y0, x1, y1;
+            c2d_tile_bounds(cortex, tx, ty, &x0, &y0, &x1, &y1);
+
+            for (bhm_cortex_size_t y = y0; y < y1; y++) {
+                for (bhm_cortex_size_t x = x0; x < x1; x++) {
+                    visit(cortex, x, y, data);
+                }
+            }
+        }
+    }
+}
+
+/// @brief Sets up the neuron at the provided coordinates of a cortex being initialized with default values.
+static void c2d_init_neuron(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, void* data) {
+    (void) data;
+    bhm_neuron_t* neuron = &(cortex->neurons[IDX2D(x, y, cortex->width)]);
+
+    neuron->synac_mask = 0x00U;
+    neuron->synex_mask = 0x00U;
+    neuron->synstr_mask_a = 0x00U;
+    neuron->synstr_mask_b = 0x00U;
+    neuron->synstr_mask_c = 0x00U;
+
+    // The starting random state should be different for each neuron, otherwise repeting patterns occur.
+    // Also the starting state should never be 0, so an arbitrary integer is added to every state.
+    neuron->rand_state = BHM_STARTING_RAND + x * y;
+    neuron->pulse_mask = 0x00U;
+    neuron->pulse = 0x00U;
+    neuron->value = BHM_DEFAULT_STARTING_VALUE;
+    neuron->max_syn_count = cortex->max_syn_count;
+    neuron->syn_count = 0x00U;
+    neuron->tot_syn_strength = 0x00U;
+    neuron->inhexc_ratio = BHM_DEFAULT_INHEXC_RATIO;
+}
+
+/// @brief Sets up the neuron at the provided coordinates of a cortex being initialized with random values.
+static void c2d_rand_init_neuron(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, void* data) {
+    (void) data;
+    bhm_neuron_t* neuron = &cortex->neurons[IDX2D(x, y, cortex->width)];
+
+    neuron->synac_mask = 0x00U;
+    neuron->synex_mask = 0x00U;
+    neuron->synstr_mask_a = 0x00U;
+    neuron->synstr_mask_b = 0x00U;
+    neuron->synstr_mask_c = 0x00U;
+
+    // The starting random state should be different for each neuron, otherwise repeting patterns occur.
+    // Also the starting state should never be 0, so an arbitrary integer is added to every state.
+    neuron->rand_state = 31 + x * y;
+    neuron->pulse_mask = 0x00U;
+    neuron->pulse = 0x00U;
+    neuron->value = BHM_DEFAULT_STARTING_VALUE;
+    neuron->rand_state = xorshf32(neuron->rand_state);
+    neuron->max_syn_count = neuron->rand_state % cortex->max_syn_count;
+    neuron->syn_count = 0x00U;
+    neuron->tot_syn_strength = 0x00U;
+    neuron->rand_state = xorshf32(neuron->rand_state);
+    neuron->inhexc_ratio = neuron->rand_state % cortex->inhexc_range;
+}
+
+/// @brief Scatters the neuron at the provided coordinates of a cortex in AOS storage mode to the SOA storage [data].
+static void c2d_scatter_neuron(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, void* data) {
+    bhm_cortex_size_t neuron_index = c2d_neuron_index(cortex, x, y);
+    soa_store_neuron((bhm_neurons_soa_t*) data, neuron_index, &(cortex->neurons[neuron_index]));
+}
+
+/// @brief Gathers the neuron at the provided coordinates of a cortex in SOA storage mode to the AOS storage [data].
+static void c2d_gather_neuron(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, void* data) {
+    bhm_cortex_size_t neuron_index = c2d_neuron_index(cortex, x, y);
+    soa_load_neuron(&(cortex->soa), neuron_index, &(((bhm_neuron_t*) data)[neuron_index]));
+}
+
+/// @brief Moves the neuron at the provided coordinates of a cortex to the same position in the storage of the cortex [data],
+/// which has the same storage mode but possibly a different layout.
+static void c2d_move_neuron(bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y, void* data) {
+    bhm_cortex2d_t* target = (bhm_cortex2d_t*) data;
+    bhm_cortex_size_t from_index = c2d_neuron_index(cortex, x, y);
+    bhm_cortex_size_t to_index = c2d_neuron_index(target, x, y);
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        bhm_neuron_t neuron;
+        soa_load_neuron(&(cortex->soa), from_index, &neuron);
+        soa_store_neuron(&(target->soa), to_index, &neuron);
+    } else {
+        target->neurons[to_index] = cortex->neurons[from_index];
+    }
+}
+
+/// @brief Moves all neurons of [cortex] to newly allocated storage in the same storage mode, laid out in [layout] and backed by [page_mode].
+/// Static state shared with another cortex is moved as well, leaving the other cortex as the only owner of the previous copy.
+static bhm_error_code_t c2d_move_storage(
+    bhm_cortex2d_t* cortex,
+    bhm_layout_t layout,
+    bhm_page_mode_t page_mode
+) {
+    // The cortex as it will be laid out, for new storage to be placed and filled accordingly.
+    bhm_cortex2d_t target = *cortex;
+    target.layout = layout;
+    target.page_mode = page_mode;
+    target.neurons = NULL;
+    target.soa = (bhm_neurons_soa_t) {0};
+
+    // Allocate new storage in the same storage mode.
+    bhm_cortex_size_t neurons_count = cortex->width * cortex->height;
+    bhm_error_code_t error = cortex->storage_mode == BHM_STORAGE_MODE_SOA ?
+        soa_alloc(&(target.soa), neurons_count, page_mode, &(target.page_size)) :
+        storage_alloc((void**) &(target.neurons), neurons_count * sizeof(bhm_neuron_t), page_mode, &(target.page_size));
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+#ifdef BHM_NUMA
+    numa_place_neurons(&target, cortex->numa_policy, cortex->storage_mode, target.neurons, &(target.soa), BHM_FALSE);
+#endif
+
+    c2d_visit_tiles(cortex, c2d_move_neuron, &target);
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        soa_free(&(cortex->soa));
+        cortex->soa = target.soa;
+    } else {
+        storage_free(cortex->neurons);
+        cortex->neurons = target.neurons;
+    }
+
+    cortex->layout = layout;
+    cortex->page_mode = page_mode;
+    cortex->page_size = target.page_size;
+
+    return BHM_ERROR_NONE;
 }
 
 
@@ -130,36 +385,49 @@ bhm_error_code_t c2d_init(
     cortex->sample_window = BHM_DEFAULT_SAMPLE_WINDOW;
     cortex->pulse_mapping = BHM_PULSE_MAPPING_LINEAR;
 
+    // Neurons always start as an array of structures stored row by row, storage mode and layout can be changed afterwards.
+    cortex->storage_mode = BHM_STORAGE_MODE_AOS;
+    cortex->layout = BHM_LAYOUT_ROW_MAJOR;
+    cortex->tick_mode = BHM_DEFAULT_TICK_MODE;
+    cortex->rand_mode = BHM_DEFAULT_RAND_MODE;
+    cortex->integration_mode = BHM_DEFAULT_INTEGRATION_MODE;
+    cortex->boundary_mode = BHM_DEFAULT_BOUNDARY_MODE;
+    cortex->tile_width = BHM_DEFAULT_TILE_WIDTH;
+    cortex->tile_height = BHM_DEFAULT_TILE_HEIGHT;
+    cortex->numa_policy = BHM_DEFAULT_NUMA_POLICY;
+    cortex->page_mode = BHM_DEFAULT_PAGE_MODE;
+    cortex->soa = (bhm_neurons_soa_t) {0};
+    cortex->fired = (bhm_fired_bitmap_t) {0};
+    cortex->events = (bhm_tile_events_t) {0};
+
     // Allocate neurons.
-    cortex->neurons = (bhm_neuron_t*) malloc(cortex->width * cortex->height * sizeof(bhm_neuron_t));
-    if (cortex->neurons == NULL) {
-        return BHM_ERROR_FAILED_ALLOC;
+    bhm_error_code_t error = storage_alloc(
+        (void**) &(cortex->neurons),
+        cortex->width * cortex->height * sizeof(bhm_neuron_t),
+        cortex->page_mode,
+        &(cortex->page_size)
+    );
+    if (error != BHM_ERROR_NONE) {
+        return error;
     }
 
-    // Setup neurons' properties.
-    for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
-        for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-            bhm_neuron_t* neuron = &(cortex->neurons[IDX2D(x, y, cortex->width)]);
-
-            neuron->synac_mask = 0x00U;
-            neuron->synex_mask = 0x00U;
-            neuron->synstr_mask_a = 0x00U;
-            neuron->synstr_mask_b = 0x00U;
-            neuron->synstr_mask_c = 0x00U;
-
-            // The starting random state should be different for each neuron, otherwise repeting patterns occur.
-            // Also the starting state should never be 0, so an arbitrary integer is added to every state.
-            neuron->rand_state = BHM_STARTING_RAND + x * y;
-            neuron->pulse_mask = 0x00U;
-            neuron->pulse = 0x00U;
-            neuron->value = BHM_DEFAULT_STARTING_VALUE;
-            neuron->max_syn_count = cortex->max_syn_count;
-            neuron->syn_count = 0x00U;
-            neuron->tot_syn_strength = 0x00U;
-            neuron->inhexc_ratio = BHM_DEFAULT_INHEXC_RATIO;
-        }
+    // Allocate the fired bitmap.
+    error = fired_alloc(&(cortex->fired), cortex->width, cortex->height, cortex->nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        c2d_deinit(cortex);
+        return error;
+    }
+
+    // Allocate the tiles activity.
+    error = events_alloc(&(cortex->events), cortex->width, cortex->height);
+    if (error != BHM_ERROR_NONE) {
+        c2d_deinit(cortex);
+        return error;
     }
 
+    // Setup neurons' properties.
+    c2d_visit_tiles(cortex, c2d_init_neuron, NULL);
+
     return BHM_ERROR_NONE;
 }
 
@@ -217,38 +485,49 @@ bhm_error_code_t c2d_rand_init(
     int pulse_mapping = cortex->rand_state % 4 + 0x100000;
     cortex->pulse_mapping = pulse_mapping;
 
+    // Neurons always start as an array of structures stored row by row, storage mode and layout can be changed afterwards.
+    cortex->storage_mode = BHM_STORAGE_MODE_AOS;
+    cortex->layout = BHM_LAYOUT_ROW_MAJOR;
+    cortex->tick_mode = BHM_DEFAULT_TICK_MODE;
+    cortex->rand_mode = BHM_DEFAULT_RAND_MODE;
+    cortex->integration_mode = BHM_DEFAULT_INTEGRATION_MODE;
+    cortex->boundary_mode = BHM_DEFAULT_BOUNDARY_MODE;
+    cortex->tile_width = BHM_DEFAULT_TILE_WIDTH;
+    cortex->tile_height = BHM_DEFAULT_TILE_HEIGHT;
+    cortex->numa_policy = BHM_DEFAULT_NUMA_POLICY;
+    cortex->page_mode = BHM_DEFAULT_PAGE_MODE;
+    cortex->soa = (bhm_neurons_soa_t) {0};
+    cortex->fired = (bhm_fired_bitmap_t) {0};
+    cortex->events = (bhm_tile_events_t) {0};
+
     // Allocate neurons.
-    cortex->neurons = (bhm_neuron_t*) malloc(cortex->width * cortex->height * sizeof(bhm_neuron_t));
-    if (cortex->neurons == NULL) {
-        return BHM_ERROR_FAILED_ALLOC;
+    bhm_error_code_t error = storage_alloc(
+        (void**) &(cortex->neurons),
+        cortex->width * cortex->height * sizeof(bhm_neuron_t),
+        cortex->page_mode,
+        &(cortex->page_size)
+    );
+    if (error != BHM_ERROR_NONE) {
+        return error;
     }
 
-    // Setup neurons' properties.
-    for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
-        for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-            bhm_neuron_t* neuron = &cortex->neurons[IDX2D(x, y, cortex->width)];
-
-            neuron->synac_mask = 0x00U;
-            neuron->synex_mask = 0x00U;
-            neuron->synstr_mask_a = 0x00U;
-            neuron->synstr_mask_b = 0x00U;
-            neuron->synstr_mask_c = 0x00U;
-
-            // The starting random state should be different for each neuron, otherwise repeting patterns occur.
-            // Also the starting state should never be 0, so an arbitrary integer is added to every state.
-            neuron->rand_state = 31 + x * y;
-            neuron->pulse_mask = 0x00U;
-            neuron->pulse = 0x00U;
-            neuron->value = BHM_DEFAULT_STARTING_VALUE;
-            neuron->rand_state = xorshf32(neuron->rand_state);
-            neuron->max_syn_count = neuron->rand_state % cortex->max_syn_count;
-            neuron->syn_count = 0x00U;
-            neuron->tot_syn_strength = 0x00U;
-            neuron->rand_state = xorshf32(neuron->rand_state);
-            neuron->inhexc_ratio = neuron->rand_state % cortex->inhexc_range;
-        }
+    // Allocate the fired bitmap.
+    error = fired_alloc(&(cortex->fired), cortex->width, cortex->height, cortex->nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        c2d_deinit(cortex);
+        return error;
+    }
+
+    // Allocate the tiles activity.
+    error = events_alloc(&(cortex->events), cortex->width, cortex->height);
+    if (error != BHM_ERROR_NONE) {
+        c2d_deinit(cortex);
+        return error;
     }
 
+    // Setup neurons' properties.
+    c2d_visit_tiles(cortex, c2d_rand_init_neuron, NULL);
+
     return BHM_ERROR_NONE;
 }
 
@@ -299,11 +578,26 @@ bhm_error_code_t o2d_destroy(
     return BHM_ERROR_NONE;
 }
 
+bhm_error_code_t c2d_deinit(
+    bhm_cortex2d_t* cortex
+) {
+    // Free neurons, whatever storage they're in.
+    storage_free(cortex->neurons);
+    cortex->neurons = NULL;
+    soa_free(&(cortex->soa));
+
+    // Free fired bitmap and tiles activity.
+    fired_free(&(cortex->fired));
+    events_free(&(cortex->events));
+
+    return BHM_ERROR_NONE;
+}
+
 bhm_error_code_t c2d_destroy(
     bhm_cortex2d_t* cortex
 ) {
     // Free neurons.
-    free(cortex->neurons);
+    c2d_deinit(cortex);
 
     // Free cortex.
     free(cortex);
@@ -315,6 +609,11 @@ bhm_error_code_t c2d_copy(
     bhm_cortex2d_t* to,
     bhm_cortex2d_t* from
 ) {
+    // Neurons can only be copied between cortices sharing the same layout, checked before anything is copied so that a failed copy leaves [to] untouched.
+    if (to->storage_mode != from->storage_mode || to->layout != from->layout) {
+        return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+
     to->width = from->width;
     to->height = from->height;
     to->ticks_count = from->ticks_count;
@@ -335,16 +634,67 @@ bhm_error_code_t c2d_copy(
 
     to->sample_window = from->sample_window;
     to->pulse_mapping = from->pulse_mapping;
+    to->tick_mode = from->tick_mode;
+    to->rand_mode = from->rand_mode;
+    to->integration_mode = from->integration_mode;
+    to->boundary_mode = from->boundary_mode;
+    to->tile_width = from->tile_width;
+    to->tile_height = from->tile_height;
+    to->numa_policy = from->numa_policy;
+
+    // Values are about to change, so make sure the fired bitmap and the tiles activity are rebuilt, and sized, accordingly.
+    bhm_error_code_t error = fired_alloc(&(to->fired), to->width, to->height, to->nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+    error = events_alloc(&(to->events), to->width, to->height);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
 
-    for (bhm_cortex_size_t y = 0; y < from->height; y++) {
-        for (bhm_cortex_size_t x = 0; x < from->width; x++) {
-            to->neurons[IDX2D(x, y, from->width)] = from->neurons[IDX2D(x, y, from->width)];
+    if (from->storage_mode == BHM_STORAGE_MODE_SOA) {
+        for (bhm_cortex_size_t i = 0; i < from->width * from->height; i++) {
+            bhm_neuron_t neuron;
+            soa_load_neuron(&(from->soa), i, &neuron);
+            soa_store_neuron(&(to->soa), i, &neuron);
+        }
+    } else {
+        for (bhm_cortex_size_t y = 0; y < from->height; y++) {
+            for (bhm_cortex_size_t x = 0; x < from->width; x++) {
+                to->neurons[IDX2D(x, y, from->width)] = from->neurons[IDX2D(x, y, from->width)];
+            }
         }
     }
 
     return BHM_ERROR_NONE;
 }
 
+bhm_error_code_t c2d_share_static(
+    bhm_cortex2d_t* to,
+    bhm_cortex2d_t* from
+) {
+    if (to->storage_mode != BHM_STORAGE_MODE_SOA || from->storage_mode != BHM_STORAGE_MODE_SOA) {
+        return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+    if (to->width != from->width || to->height != from->height) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+    if (to->layout != from->layout) {
+        return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+
+    // Already sharing.
+    if (soa_shares_static(&(to->soa), &(from->soa))) {
+        return BHM_ERROR_NONE;
+    }
+
+    soa_share_static(&(to->soa), &(from->soa));
+
+    events_invalidate(&(to->events));
+
+    return BHM_ERROR_NONE;
+}
+
 // ##########################################
 // ##########################################
 
@@ -364,6 +714,11 @@ bhm_error_code_t c2d_set_nhradius(
 
     cortex->nh_radius = radius;
 
+    // The fired bitmap needs as many ghost rows as the new radius, rebuilding it is left to the next tick.
+    if (cortex->fired.ghost_rows != radius) {
+        return fired_alloc(&(cortex->fired), cortex->width, cortex->height, radius);
+    }
+
     return BHM_ERROR_NONE;
 }
 
@@ -373,10 +728,16 @@ bhm_error_code_t c2d_set_nhmask(
 ) {
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-            cortex->neurons[IDX2D(x, y, cortex->width)].synac_mask = mask;
+            if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                cortex->soa.synac_mask[c2d_neuron_index(cortex, x, y)] = mask;
+            } else {
+                cortex->neurons[c2d_neuron_index(cortex, x, y)].synac_mask = mask;
+            }
         }
     }
 
+    events_invalidate(&(cortex->events));
+
     return BHM_ERROR_NONE;
 }
 
@@ -416,6 +777,10 @@ bhm_error_code_t c2d_set_fire_threshold(
 ) {
     cortex->fire_threshold = threshold;
 
+    // Neurons over threshold change along with it.
+    cortex->fired.valid = BHM_FALSE;
+    events_invalidate(&(cortex->events));
+
     return BHM_ERROR_NONE;
 }
 
@@ -485,11 +850,17 @@ bhm_error_code_t c2d_set_inhexc_ratio(
     if (inhexc_ratio <= cortex->inhexc_range) {
         for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
             for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-                cortex->neurons[IDX2D(x, y, cortex->width)].inhexc_ratio = inhexc_ratio;
+                if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                    cortex->soa.inhexc_ratio[c2d_neuron_index(cortex, x, y)] = inhexc_ratio;
+                } else {
+                    cortex->neurons[c2d_neuron_index(cortex, x, y)].inhexc_ratio = inhexc_ratio;
+                }
             }
         }
     }
 
+    events_invalidate(&(cortex->events));
+
     return BHM_ERROR_NONE;
 }
 
@@ -504,11 +875,212 @@ bhm_error_code_t c2d_syn_disable(
     if (x0 >= 0 && y0 >= 0 && x1 <= cortex->width && y1 <= cortex->height) {
         for (bhm_cortex_size_t y = y0; y < y1; y++) {
             for (bhm_cortex_size_t x = x0; x < x1; x++) {
-                cortex->neurons[IDX2D(x, y, cortex->width)].max_syn_count = 0x00U;
+                if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                    cortex->soa.max_syn_count[c2d_neuron_index(cortex, x, y)] = 0x00U;
+                } else {
+                    cortex->neurons[c2d_neuron_index(cortex, x, y)].max_syn_count = 0x00U;
+                }
             }
         }
     }
 
+    events_invalidate(&(cortex->events));
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_storage_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_storage_mode_t storage_mode
+) {
+    bhm_cortex_size_t neurons_count = cortex->width * cortex->height;
+
+    // Nothing to convert.
+    if (cortex->storage_mode == storage_mode) {
+        return BHM_ERROR_NONE;
+    }
+
+    switch (storage_mode) {
+        case BHM_STORAGE_MODE_SOA: {
+            bhm_neurons_soa_t soa;
+            bhm_error_code_t error = soa_alloc(&soa, neurons_count, cortex->page_mode, &(cortex->page_size));
+            if (error != BHM_ERROR_NONE) {
+                return error;
+            }
+#ifdef BHM_NUMA
+            numa_place_neurons(cortex, cortex->numa_policy, BHM_STORAGE_MODE_SOA, NULL, &soa, BHM_FALSE);
+#endif
+
+            // Scatter neurons to their own arrays.
+            c2d_visit_tiles(cortex, c2d_scatter_neuron, &soa);
+
+            storage_free(cortex->neurons);
+            cortex->neurons = NULL;
+            cortex->soa = soa;
+            break;
+        }
+        case BHM_STORAGE_MODE_AOS: {
+            bhm_neuron_t* neurons;
+            bhm_error_code_t error = storage_alloc((void**) &neurons, neurons_count * sizeof(bhm_neuron_t), cortex->page_mode, &(cortex->page_size));
+            if (error != BHM_ERROR_NONE) {
+                return error;
+            }
+#ifdef BHM_NUMA
+            numa_place_neurons(cortex, cortex->numa_policy, BHM_STORAGE_MODE_AOS, neurons, NULL, BHM_FALSE);
+#endif
+
+            // Gather neurons back from their arrays.
+            c2d_visit_tiles(cortex, c2d_gather_neuron, neurons);
+
+            soa_free(&(cortex->soa));
+            cortex->neurons = neurons;
+            break;
+        }
+        default:
+            return BHM_ERROR_STORAGE_MODE_WRONG;
+    }
+
+    cortex->storage_mode = storage_mode;
+    events_invalidate(&(cortex->events));
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_tick_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_tick_mode_t tick_mode
+) {
+    cortex->tick_mode = tick_mode;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_rand_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_rand_mode_t rand_mode
+) {
+    cortex->rand_mode = rand_mode;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_integration_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_integration_mode_t integration_mode
+) {
+    cortex->integration_mode = integration_mode;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_boundary_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_boundary_mode_t boundary_mode
+) {
+    cortex->boundary_mode = boundary_mode;
+
+    // The ghost border now mirrors different positions.
+    cortex->fired.ghosts_valid = BHM_FALSE;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_tile_size(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t tile_width,
+    bhm_cortex_size_t tile_height
+) {
+    // Tiles must not share fired bitmap words.
+    if (tile_width <= 0 || tile_width % 64 != 0 || tile_height <= 0) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    cortex->tile_width = tile_width;
+    cortex->tile_height = tile_height;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_numa_policy(
+    bhm_cortex2d_t* cortex,
+    bhm_numa_policy_t numa_policy
+) {
+    if (numa_policy != BHM_NUMA_POLICY_FIRST_TOUCH && numa_policy != BHM_NUMA_POLICY_INTERLEAVE) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+
+#ifdef BHM_NUMA
+    if (numa_available() < 0) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+
+    // Move the current storage right away.
+    numa_place_neurons(cortex, numa_policy, cortex->storage_mode, cortex->neurons, &(cortex->soa), BHM_TRUE);
+#else
+    // Explicit placement needs libnuma.
+    if (numa_policy != BHM_NUMA_POLICY_FIRST_TOUCH) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    cortex->numa_policy = numa_policy;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_page_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_page_mode_t page_mode
+) {
+    if (page_mode != BHM_PAGE_MODE_BASE && page_mode != BHM_PAGE_MODE_TRANSPARENT_HUGE && page_mode != BHM_PAGE_MODE_EXPLICIT_HUGE) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+
+    return c2d_move_storage(cortex, cortex->layout, page_mode);
+}
+
+bhm_error_code_t c2d_set_layout(
+    bhm_cortex2d_t* cortex,
+    bhm_layout_t layout
+) {
+    if (layout != BHM_LAYOUT_ROW_MAJOR && layout != BHM_LAYOUT_BRICK) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+    if (layout == cortex->layout) {
+        return BHM_ERROR_NONE;
+    }
+
+    bhm_error_code_t error = c2d_move_storage(cortex, layout, cortex->page_mode);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    // The fired bitmap is kept by position, so it still holds, while tiles can't be known to match any other cortex' anymore.
+    events_invalidate(&(cortex->events));
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t c2d_set_neuron(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_neuron_t* neuron
+) {
+    // Make sure the provided coordinates are within the cortex size.
+    if (x < 0 || y < 0 || x >= cortex->width || y >= cortex->height) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        soa_store_neuron(&(cortex->soa), c2d_neuron_index(cortex, x, y), neuron);
+    } else {
+        cortex->neurons[c2d_neuron_index(cortex, x, y)] = *neuron;
+    }
+
+    cortex->fired.valid = BHM_FALSE;
+    events_invalidate(&(cortex->events));
+
     return BHM_ERROR_NONE;
 }
 
@@ -587,10 +1159,19 @@ bhm_error_code_t c2d_mutate(
     // Mutate neurons.
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-            n2d_mutate(&(cortex->neurons[IDX2D(x, y, cortex->width)]), mut_chance);
+            if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                bhm_neuron_t neuron;
+                soa_load_neuron(&(cortex->soa), c2d_neuron_index(cortex, x, y), &neuron);
+                n2d_mutate(&neuron, mut_chance);
+                soa_store_neuron(&(cortex->soa), c2d_neuron_index(cortex, x, y), &neuron);
+            } else {
+                n2d_mutate(&(cortex->neurons[c2d_neuron_index(cortex, x, y)]), mut_chance);
+            }
         }
     }
 
+    events_invalidate(&(cortex->events));
+
     return BHM_ERROR_NONE;
 }
 
@@ -645,6 +1226,26 @@ bhm_error_code_t c2d_to_string(
     return BHM_ERROR_NONE;
 }
 
+bhm_error_code_t c2d_get_neuron(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_neuron_t* neuron
+) {
+    // Make sure the provided coordinates are within the cortex size.
+    if (x < 0 || y < 0 || x >= cortex->width || y >= cortex->height) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        soa_load_neuron(&(cortex->soa), c2d_neuron_index(cortex, x, y), neuron);
+    } else {
+        *neuron = cortex->neurons[c2d_neuron_index(cortex, x, y)];
+    }
+
+    return BHM_ERROR_NONE;
+}
+
 bhm_error_code_t i2d_mean(
     bhm_input2d_t* input,
     bhm_ticks_count_t* result
@@ -695,25 +1296,386 @@ bhm_error_code_t o2d_mean(
 // Utility Functions.
 // ##########################################
 
+#ifdef __linux__
+/// @brief Returns the size of huge pages reserved by the system, as listed in /proc/meminfo, or 0 if not available.
+static size_t explicit_huge_page_size() {
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo == NULL) {
+        return 0;
+    }
+
+    size_t size_kb = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), meminfo) != NULL) {
+        if (sscanf(line, "Hugepagesize: %zu kB", &size_kb) == 1) {
+            break;
+        }
+    }
+
+    fclose(meminfo);
+
+    return size_kb * 1024;
+}
+
+/// @brief Returns the size of transparent huge pages, or 0 if they're disabled on the system.
+static size_t transparent_huge_page_size() {
+    char line[128] = {0};
+
+    FILE* enabled = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (enabled == NULL) {
+        return 0;
+    }
+    char* read = fgets(line, sizeof(line), enabled);
+    fclose(enabled);
+    if (read == NULL || strstr(line, "[never]") != NULL) {
+        return 0;
+    }
+
+    FILE* pmd_size = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+    if (pmd_size == NULL) {
+        return 0;
+    }
+    size_t size = 0;
+    if (fscanf(pmd_size, "%zu", &size) != 1) {
+        size = 0;
+    }
+    fclose(pmd_size);
+
+    return size;
+}
+#endif
+
+// Bookkeeping kept right before each storage array, in the room left by its alignment.
+typedef struct {
+    // Start and length of the whole underlying allocation.
+    void* base;
+    size_t length;
+
+    // Whether the allocation was mapped directly rather than allocated on the heap.
+    bhm_bool_t mapped;
+} bhm_storage_header_t;
+
+_Static_assert(sizeof(bhm_storage_header_t) <= BHM_STORAGE_ALIGNMENT, "Storage header must fit in the storage alignment");
+
+/// @brief Lays storage out at [start], which must be aligned to BHM_STORAGE_ALIGNMENT, recording the allocation it belongs to.
+static void* storage_setup(
+    void* start,
+    void* base,
+    size_t length,
+    bhm_bool_t mapped
+) {
+    *((bhm_storage_header_t*) start) = (bhm_storage_header_t) {
+        .base = base,
+        .length = length,
+        .mapped = mapped
+    };
+
+    return (bhm_byte*) start + BHM_STORAGE_ALIGNMENT;
+}
+
+bhm_error_code_t storage_alloc(
+    void** storage,
+    size_t size,
+    bhm_page_mode_t page_mode,
+    size_t* page_size
+) {
+    *storage = NULL;
+
+    // Room for the storage and its header, which takes a whole alignment step.
+    size_t length = BHM_STORAGE_ALIGNMENT + (size + BHM_STORAGE_ALIGNMENT - 1) / BHM_STORAGE_ALIGNMENT * BHM_STORAGE_ALIGNMENT;
+    size_t obtained_page_size = 4096;
+
+#ifdef __linux__
+    obtained_page_size = (size_t) sysconf(_SC_PAGESIZE);
+
+    // Storage backed by huge pages would otherwise always start at the same offset in a page, making the same neuron in different
+    // arrays compete for the same cache sets: stagger each allocation by a different amount of cache lines.
+    static uint32_t colours_count = 0;
+    uint32_t colour;
+    #pragma omp atomic capture
+    colour = colours_count++;
+    size_t colour_offset = (colour % BHM_STORAGE_COLOURS) * BHM_STORAGE_COLOUR_STEP;
+
+    // Huge pages are only worth it for storage spanning at least one of them.
+    if (page_mode == BHM_PAGE_MODE_EXPLICIT_HUGE) {
+        size_t huge_page_size = explicit_huge_page_size();
+        if (huge_page_size > 0 && length >= huge_page_size) {
+            size_t mapped_length = (colour_offset + length + huge_page_size - 1) / huge_page_size * huge_page_size;
+            void* base = mmap(NULL, mapped_length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (base != MAP_FAILED) {
+                *storage = storage_setup((bhm_byte*) base + colour_offset, base, mapped_length, BHM_TRUE);
+                obtained_page_size = huge_page_size;
+            }
+        }
+    }
+
+    // Explicit huge pages fall back to transparent ones if none are left.
+    if (*storage == NULL && page_mode != BHM_PAGE_MODE_BASE) {
+        size_t huge_page_size = transparent_huge_page_size();
+        if (huge_page_size > 0 && length >= huge_page_size) {
+            // Map an extra huge page, so that the storage can start on a huge page boundary.
+            size_t huge_length = (colour_offset + length + huge_page_size - 1) / huge_page_size * huge_page_size;
+            size_t mapped_length = huge_length + huge_page_size;
+            void* base = mmap(NULL, mapped_length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base != MAP_FAILED) {
+                bhm_byte* start = (bhm_byte*) (((uintptr_t) base + huge_page_size - 1) & ~((uintptr_t) huge_page_size - 1));
+                madvise(start, huge_length, MADV_HUGEPAGE);
+                *storage = storage_setup(start + colour_offset, base, mapped_length, BHM_TRUE);
+                obtained_page_size = huge_page_size;
+            }
+        }
+    }
+#else
+    (void) page_mode;
+#endif
+
+    // Regular pages, from the heap.
+    if (*storage == NULL) {
+        void* base = aligned_alloc(BHM_STORAGE_ALIGNMENT, length);
+        if (base == NULL) {
+            return BHM_ERROR_FAILED_ALLOC;
+        }
+        *storage = storage_setup(base, base, length, BHM_FALSE);
+    }
+
+    if (page_size != NULL) {
+        *page_size = obtained_page_size;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t storage_free(
+    void* storage
+) {
+    if (storage == NULL) {
+        return BHM_ERROR_NONE;
+    }
+
+    // The header lives in the allocation itself, so read it before releasing it.
+    bhm_storage_header_t header = *((bhm_storage_header_t*) ((bhm_byte*) storage - BHM_STORAGE_ALIGNMENT));
+
+#ifdef __linux__
+    if (header.mapped) {
+        munmap(header.base, header.length);
+        return BHM_ERROR_NONE;
+    }
+#endif
+
+    free(header.base);
+
+    return BHM_ERROR_NONE;
+}
+
+/// @brief Allocates a single SoA array, keeping track in [page_size] of the smallest page size obtained so far.
+static void* soa_alloc_array(
+    size_t size,
+    bhm_page_mode_t page_mode,
+    size_t* page_size
+) {
+    void* array;
+    size_t array_page_size;
+    if (storage_alloc(&array, size, page_mode, &array_page_size) != BHM_ERROR_NONE) {
+        return NULL;
+    }
+
+    if (array_page_size < *page_size) {
+        *page_size = array_page_size;
+    }
+
+    return array;
+}
+
+bhm_error_code_t soa_alloc(
+    bhm_neurons_soa_t* soa,
+    bhm_cortex_size_t count,
+    bhm_page_mode_t page_mode,
+    size_t* page_size
+) {
+    size_t smallest_page_size = SIZE_MAX;
+
+    soa->synac_mask = (bhm_nh_mask_t*) soa_alloc_array(count * sizeof(bhm_nh_mask_t), page_mode, &smallest_page_size);
+    soa->synex_mask = (bhm_nh_mask_t*) soa_alloc_array(count * sizeof(bhm_nh_mask_t), page_mode, &smallest_page_size);
+    soa->synstr_mask_a = (bhm_nh_mask_t*) soa_alloc_array(count * sizeof(bhm_nh_mask_t), page_mode, &smallest_page_size);
+    soa->synstr_mask_b = (bhm_nh_mask_t*) soa_alloc_array(count * sizeof(bhm_nh_mask_t), page_mode, &smallest_page_size);
+    soa->synstr_mask_c = (bhm_nh_mask_t*) soa_alloc_array(count * sizeof(bhm_nh_mask_t), page_mode, &smallest_page_size);
+    soa->max_syn_count = (bhm_syn_count_t*) soa_alloc_array(count * sizeof(bhm_syn_count_t), page_mode, &smallest_page_size);
+    soa->syn_count = (bhm_syn_count_t*) soa_alloc_array(count * sizeof(bhm_syn_count_t), page_mode, &smallest_page_size);
+    soa->tot_syn_strength = (bhm_syn_strength_t*) soa_alloc_array(count * sizeof(bhm_syn_strength_t), page_mode, &smallest_page_size);
+    soa->inhexc_ratio = (bhm_chance_t*) soa_alloc_array(count * sizeof(bhm_chance_t), page_mode, &smallest_page_size);
+    soa->static_refs = (uint32_t*) malloc(sizeof(uint32_t));
+    soa->rand_state = (bhm_rand_state_t*) soa_alloc_array(count * sizeof(bhm_rand_state_t), page_mode, &smallest_page_size);
+    soa->pulse_mask = (bhm_pulse_mask_t*) soa_alloc_array(count * sizeof(bhm_pulse_mask_t), page_mode, &smallest_page_size);
+    soa->pulse = (bhm_ticks_count_t*) soa_alloc_array(count * sizeof(bhm_ticks_count_t), page_mode, &smallest_page_size);
+    soa->value = (bhm_neuron_value_t*) soa_alloc_array(count * sizeof(bhm_neuron_value_t), page_mode, &smallest_page_size);
+
+    if (soa->static_refs != NULL) {
+        *(soa->static_refs) = 1;
+    }
+
+    if (soa->synac_mask == NULL || soa->synex_mask == NULL ||
+        soa->synstr_mask_a == NULL || soa->synstr_mask_b == NULL || soa->synstr_mask_c == NULL ||
+        soa->max_syn_count == NULL || soa->syn_count == NULL || soa->tot_syn_strength == NULL || soa->inhexc_ratio == NULL ||
+        soa->static_refs == NULL || soa->rand_state == NULL || soa->pulse_mask == NULL || soa->pulse == NULL || soa->value == NULL) {
+        soa_free(soa);
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    if (page_size != NULL) {
+        *page_size = smallest_page_size;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t soa_free(
+    bhm_neurons_soa_t* soa
+) {
+    // Static state is only freed along with the last storage sharing it.
+    if (soa->static_refs == NULL || --*(soa->static_refs) == 0) {
+        storage_free(soa->synac_mask);
+        storage_free(soa->synex_mask);
+        storage_free(soa->synstr_mask_a);
+        storage_free(soa->synstr_mask_b);
+        storage_free(soa->synstr_mask_c);
+        storage_free(soa->max_syn_count);
+        storage_free(soa->syn_count);
+        storage_free(soa->tot_syn_strength);
+        storage_free(soa->inhexc_ratio);
+        free(soa->static_refs);
+    }
+
+    storage_free(soa->rand_state);
+    storage_free(soa->pulse_mask);
+    storage_free(soa->pulse);
+    storage_free(soa->value);
+
+    // Leave the storage empty.
+    *soa = (bhm_neurons_soa_t) {0};
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t soa_share_static(
+    bhm_neurons_soa_t* to,
+    bhm_neurons_soa_t* from
+) {
+    // Already sharing.
+    if (soa_shares_static(to, from)) {
+        return BHM_ERROR_NONE;
+    }
+
+    // Release the destination's own static state, keeping its dynamic state.
+    bhm_neurons_soa_t dynamic = *to;
+    to->rand_state = NULL;
+    to->pulse_mask = NULL;
+    to->pulse = NULL;
+    to->value = NULL;
+    soa_free(to);
+
+    *to = *from;
+    to->rand_state = dynamic.rand_state;
+    to->pulse_mask = dynamic.pulse_mask;
+    to->pulse = dynamic.pulse;
+    to->value = dynamic.value;
+    (*(from->static_refs))++;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t fired_alloc(
+    bhm_fired_bitmap_t* fired,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_nh_radius_t nh_radius
+) {
+    fired_free(fired);
+
+    bhm_cortex_size_t row_words = (width + 63) / 64;
+    bhm_cortex_size_t row_stride = row_words + 2;
+
+    // Rows are preceded by their left ghost word, so the first real word is one past the start of its row.
+    bhm_fired_word_t* base = (bhm_fired_word_t*) calloc((height + 2 * nh_radius) * row_stride + 1, sizeof(bhm_fired_word_t));
+    if (base == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    fired->row_words = row_words;
+    fired->row_stride = row_stride;
+    fired->ghost_rows = nh_radius;
+    fired->words = base + nh_radius * row_stride + 1;
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t fired_free(
+    bhm_fired_bitmap_t* fired
+) {
+    if (fired->words != NULL) {
+        free(fired->words - fired->ghost_rows * fired->row_stride - 1);
+    }
+
+    // Leave the bitmap empty.
+    *fired = (bhm_fired_bitmap_t) {0};
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t events_alloc(
+    bhm_tile_events_t* events,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height
+) {
+    // Versions keep increasing across allocations, so that cortices ticked from the previous allocation never match it.
+    uint64_t version = events->version + 1;
+
+    events_free(events);
+    events->version = version;
+
+    events->width = (width + BHM_EVENT_TILE_WIDTH - 1) / BHM_EVENT_TILE_WIDTH;
+    events->height = (height + BHM_EVENT_TILE_HEIGHT - 1) / BHM_EVENT_TILE_HEIGHT;
+    events->flags = (bhm_byte*) calloc(events->width * events->height, sizeof(bhm_byte));
+    if (events->flags == NULL) {
+        events->width = 0;
+        events->height = 0;
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t events_free(
+    bhm_tile_events_t* events
+) {
+    free(events->flags);
+
+    // Leave the tiles activity empty, only keeping its version.
+    *events = (bhm_tile_events_t) {.version = events->version};
+
+    return BHM_ERROR_NONE;
+}
+
 bhm_error_code_t c2d_add_row(
     bhm_cortex2d_t* cortex,
     bhm_cortex_size_t index
 ) {
+    if (cortex->storage_mode != BHM_STORAGE_MODE_AOS) return BHM_ERROR_STORAGE_MODE_WRONG;
     if (index > cortex->height - 1) return BHM_ERROR_SIZE_WRONG;
 
     bhm_cortex_size_t new_height = cortex->height + 1;
 
     // Allocate a temporary array of neurons.
-    bhm_neuron_t* tmp_neurons = (bhm_neuron_t*) malloc(cortex->width * new_height * sizeof(bhm_neuron_t));
-    if (tmp_neurons == NULL) return BHM_ERROR_FAILED_ALLOC;
+    bhm_neuron_t* tmp_neurons;
+    size_t page_size;
+    if (storage_alloc((void**) &tmp_neurons, cortex->width * new_height * sizeof(bhm_neuron_t), cortex->page_mode, &page_size) != BHM_ERROR_NONE) return BHM_ERROR_FAILED_ALLOC;
 
-    // Move all neurons to their new location.
+    // Move all neurons to their new location, in the current layout as laid out for the new height.
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
             if (y < index) {
-                tmp_neurons[IDX2D(x, y, cortex->width)] = cortex->neurons[IDX2D(x, y, cortex->width)];
-            } else if (y > index) {
-                tmp_neurons[IDX2D(x, y + 1, cortex->width)] = cortex->neurons[IDX2D(x, y, cortex->width)];
+                tmp_neurons[layout_index(cortex->layout, cortex->width, new_height, x, y)] = cortex->neurons[c2d_neuron_index(cortex, x, y)];
+            } else {
+                tmp_neurons[layout_index(cortex->layout, cortex->width, new_height, x, y + 1)] = cortex->neurons[c2d_neuron_index(cortex, x, y)];
             }
         }
     }
@@ -721,7 +1683,7 @@ bhm_error_code_t c2d_add_row(
     // Initialize any new neurons with values from their neighbors.
     for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
         bhm_cortex_size_t y = index;
-        bhm_neuron_t* neuron = &(cortex->neurons[IDX2D(x, y, cortex->width)]);
+        bhm_neuron_t* neuron = &(tmp_neurons[layout_index(cortex->layout, cortex->width, new_height, x, y)]);
 
         neuron->synac_mask = 0x00U;
         neuron->synex_mask = 0x00U;
@@ -746,10 +1708,10 @@ bhm_error_code_t c2d_add_row(
             for (bhm_nh_radius_t i = 0; i < nh_diameter; i++) {
                 if (i == x && j == y) continue;
 
-                bhm_cortex_size_t neighbor_index = IDX2D(
+                bhm_cortex_size_t neighbor_index = c2d_neuron_index(
+                    cortex,
                     WRAP(i, cortex->width),
-                    WRAP(j, cortex->height),
-                    cortex->width
+                    WRAP(j, cortex->height)
                 );
 
                 bhm_neuron_t neighbor = cortex->neurons[neighbor_index];
@@ -770,10 +1732,16 @@ bhm_error_code_t c2d_add_row(
     }
 
     cortex->height = new_height;
-    free(cortex->neurons);
+    storage_free(cortex->neurons);
     cortex->neurons = tmp_neurons;
+    cortex->page_size = page_size;
 
-    return BHM_ERROR_NONE;
+    bhm_error_code_t error = fired_alloc(&(cortex->fired), cortex->width, cortex->height, cortex->nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    return events_alloc(&(cortex->events), cortex->width, cortex->height);
 }
 
 bhm_error_code_t c2d_add_column(
@@ -804,31 +1772,39 @@ bhm_error_code_t c2d_remove_row(
     bhm_cortex2d_t* cortex,
     bhm_cortex_size_t index
 ) {
+    if (cortex->storage_mode != BHM_STORAGE_MODE_AOS) return BHM_ERROR_STORAGE_MODE_WRONG;
     if (cortex->height <= 1) return BHM_ERROR_SIZE_WRONG;
     if (index > cortex->height - 1) return BHM_ERROR_SIZE_WRONG;
 
     bhm_cortex_size_t new_height = cortex->height - 1;
 
     // Allocate a temporary array of neurons.
-    bhm_neuron_t* tmp_neurons = (bhm_neuron_t*) malloc(cortex->width * new_height * sizeof(bhm_neuron_t));
-    if (tmp_neurons == NULL) return BHM_ERROR_FAILED_ALLOC;
+    bhm_neuron_t* tmp_neurons;
+    size_t page_size;
+    if (storage_alloc((void**) &tmp_neurons, cortex->width * new_height * sizeof(bhm_neuron_t), cortex->page_mode, &page_size) != BHM_ERROR_NONE) return BHM_ERROR_FAILED_ALLOC;
 
-    // Move all neurons to their new location.
+    // Move all neurons to their new location, in the current layout as laid out for the new height.
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
             if (y < index) {
-                tmp_neurons[IDX2D(x, y, cortex->width)] = cortex->neurons[IDX2D(x, y, cortex->width)];
+                tmp_neurons[layout_index(cortex->layout, cortex->width, new_height, x, y)] = cortex->neurons[c2d_neuron_index(cortex, x, y)];
             } else if (y > index) {
-                tmp_neurons[IDX2D(x, y - 1, cortex->width)] = cortex->neurons[IDX2D(x, y, cortex->width)];
+                tmp_neurons[layout_index(cortex->layout, cortex->width, new_height, x, y - 1)] = cortex->neurons[c2d_neuron_index(cortex, x, y)];
             }
         }
     }
 
     cortex->height = new_height;
-    free(cortex->neurons);
+    storage_free(cortex->neurons);
     cortex->neurons = tmp_neurons;
+    cortex->page_size = page_size;
 
-    return BHM_ERROR_NONE;
+    bhm_error_code_t error = fired_alloc(&(cortex->fired), cortex->width, cortex->height, cortex->nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    return events_alloc(&(cortex->events), cortex->width, cortex->height);
 }
 
 bhm_error_code_t c2d_remove_column(
@@ -858,27 +1834,36 @@ bhm_error_code_t c2d_remove_column(
 bhm_error_code_t c2d_transpose(
     bhm_cortex2d_t* cortex
 ) {
+    if (cortex->storage_mode != BHM_STORAGE_MODE_AOS) return BHM_ERROR_STORAGE_MODE_WRONG;
+
     // Allocate a temporary neurons array.
-    bhm_neuron_t* tmp_neurons = (bhm_neuron_t*) malloc(cortex->width * cortex->height * sizeof(bhm_neuron_t));
-    if (tmp_neurons == NULL) return BHM_ERROR_FAILED_ALLOC;
+    bhm_neuron_t* tmp_neurons;
+    size_t page_size;
+    if (storage_alloc((void**) &tmp_neurons, cortex->width * cortex->height * sizeof(bhm_neuron_t), cortex->page_mode, &page_size) != BHM_ERROR_NONE) return BHM_ERROR_FAILED_ALLOC;
 
     // Transpose the neurons matrix by 
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-            tmp_neurons[IDX2D(y, x, cortex->height)] = cortex->neurons[IDX2D(x, y, cortex->width)];
+            tmp_neurons[layout_index(cortex->layout, cortex->height, cortex->width, y, x)] = cortex->neurons[c2d_neuron_index(cortex, x, y)];
         }
     }
 
     // Store the newly populated neurons in the cortex.
-    free(cortex->neurons);
+    storage_free(cortex->neurons);
     cortex->neurons = tmp_neurons;
+    cortex->page_size = page_size;
 
     // Swap width with height.
     bhm_cortex_size_t cortex_width = cortex->width;
     cortex->width = cortex->height;
     cortex->height = cortex_width;
 
-    return BHM_ERROR_NONE;
+    bhm_error_code_t error = fired_alloc(&(cortex->fired), cortex->width, cortex->height, cortex->nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    return events_alloc(&(cortex->events), cortex->width, cortex->height);
 }
 
 // ##########################################
@@ -24,7 +24,7 @@ extern "C" {
 // WARNING: Only works with signed types and does not show errors otherwise.
 // [i] is the given index.
 // [n] is the size over which to wrap.
-#define WRAP(i, n) ((i) >= 0 ? ((i) % (n)) : ((n) + ((i) % (n))))
+#define WRAP(i, n) ((i) >= 0 ? ((i) % (n)) : (((n) + ((i) % (n))) % (n)))
 
 // Computes the diameter of a square neighborhood given its radius.
 #define NH_DIAM_2D(r) (2 * (r) + 1)
@@ -77,6 +77,41 @@ extern "C" {
 #define BHM_DEFAULT_MAX_TOT_STRENGTH 0x20U
 #define BHM_DEFAULT_SYNGEN_CHANCE 0x02A0U
 #define BHM_DEFAULT_SYNSTR_CHANCE 0x00A0U
+#define BHM_DEFAULT_TICK_MODE BHM_TICK_MODE_SIMD
+#define BHM_DEFAULT_RAND_MODE BHM_RAND_MODE_CONTINUOUS
+#define BHM_DEFAULT_INTEGRATION_MODE BHM_INTEGRATION_MODE_SEQUENTIAL
+#define BHM_DEFAULT_BOUNDARY_MODE BHM_BOUNDARY_MODE_OPEN
+#define BHM_DEFAULT_NUMA_POLICY BHM_NUMA_POLICY_FIRST_TOUCH
+#define BHM_DEFAULT_PAGE_MODE BHM_PAGE_MODE_TRANSPARENT_HUGE
+#define BHM_DEFAULT_TILE_WIDTH 0x100U
+#define BHM_DEFAULT_TILE_HEIGHT 0x20U
+
+// Size of the tiles whose activity is tracked for event-driven ticks. Tiles are exactly as wide as a fired bitmap word, so that they never share words,
+// and taller than any neighborhood radius, so that the halo of a tile never goes past its adjacent tiles.
+#define BHM_EVENT_TILE_WIDTH 0x40U
+#define BHM_EVENT_TILE_HEIGHT 0x10U
+
+// Side of the square bricks neurons are grouped into in brick layout. A brick of AOS neurons spans a few KB, and
+// the neighborhood of any neuron with a radius up to 3 falls within at most four of them.
+#define BHM_BRICK_SIDE 0x08U
+
+// Alignment of all neuron storage arrays, as wide as a cache line and as the widest SIMD registers.
+#define BHM_STORAGE_ALIGNMENT 0x40U
+// Staggering of storage arrays backed by huge pages: each one starts a different multiple of the step past its first page.
+// The step is just over a 4 KB page, so that arrays fall in different cache sets at both 4 KB and larger strides.
+#define BHM_STORAGE_COLOURS 0x10U
+#define BHM_STORAGE_COLOUR_STEP (0x43U * BHM_STORAGE_ALIGNMENT)
+
+// Minimum amount of tiles per thread for a cortex to be ticked by the whole thread team in batched ticks, rather than by a single thread.
+#define BHM_BATCH_SHARED_TILES 0x02U
+
+// Tile activity flags.
+// Some neuron in the tile has a non-zero value or pulse mask.
+#define BHM_TILE_LIVE 0x01U
+// Some neuron in the tile is over the fire threshold.
+#define BHM_TILE_FIRED 0x02U
+// The tile is known to be identical to the same tile in the cortex it was ticked from.
+#define BHM_TILE_CLEAN 0x04U
 
 #define BHM_MAX_EVOL_STEP BHM_EVOL_STEP_NEVER
 #define BHM_MAX_PULSE_WINDOW 0xFFU
@@ -97,8 +132,16 @@ typedef uint8_t bhm_byte;
 typedef int16_t bhm_neuron_value_t;
 
 // A mask made of 8 bytes can hold up to 48 neighbors (i.e. radius = 3).
-// Using 16 bytes the radius can be up to 5 (120 neighbors).
+// Using 16 bytes the radius can be up to 5 (120 neighbors): building with BHM_WIDE_NH defined switches to 16 bytes masks,
+// at the cost of twice the synapse masks memory for all cortices, whatever their radius.
+#ifdef BHM_WIDE_NH
+__extension__ typedef unsigned __int128 bhm_nh_mask_t;
+#else
 typedef uint64_t bhm_nh_mask_t;
+#endif
+// Amount of 64 bits words in a neighborhood mask.
+#define BHM_NH_MASK_WORDS (sizeof(bhm_nh_mask_t) / sizeof(uint64_t))
+typedef uint64_t bhm_fired_word_t;
 typedef int8_t bhm_nh_radius_t;
 typedef uint8_t bhm_syn_count_t;
 typedef uint8_t bhm_syn_strength_t;
@@ -127,6 +170,88 @@ typedef enum {
     BHM_PULSE_MAPPING_DFPROP = 0x100003U,
 } bhm_pulse_mapping_t;
 
+typedef enum {
+    // Array of structures: every neuron is stored as a whole bhm_neuron_t in the cortex' neurons array.
+    BHM_STORAGE_MODE_AOS = 0x200000U,
+    // Structure of arrays: every neuron property is stored in its own contiguous array in the cortex' soa block.
+    BHM_STORAGE_MODE_SOA = 0x200001U
+} bhm_storage_mode_t;
+
+typedef enum {
+    // Scalar kernel: neurons are updated one at a time.
+    BHM_TICK_MODE_SCALAR = 0x300000U,
+    // Vectorized kernel: several horizontally adjacent neurons are updated at once using AVX2 or AVX-512, whichever is available at runtime.
+    // Only non-evolution ticks on SOA cortices with sequential integration are vectorized, the scalar kernel is used in any other case,
+    // so results are always the same as SCALAR.
+    BHM_TICK_MODE_SIMD = 0x300001U,
+    // Event-driven kernel: only tiles holding live neurons (non-zero value or pulse mask) or bordering firing ones are updated,
+    // quiescent tiles are skipped altogether, so that the cost of a tick scales with activity rather than with the cortex size.
+    // Only non-evolution ticks with a rand mode other than CONTINUOUS and a non-negative fire threshold are event-driven,
+    // the scalar kernel is used in any other case, so results are always the same as SCALAR.
+    BHM_TICK_MODE_EVENT = 0x300002U
+} bhm_tick_mode_t;
+
+typedef enum {
+    // Each neuron's random state advances once per neighbor inside the cortex at every tick, evolution or not.
+    // Non-evolution ticks jump the random state ahead in closed form instead of drawing each number, so they still skip all plasticity work.
+    BHM_RAND_MODE_CONTINUOUS = 0x400000U,
+    // Each neuron's random state advances once per neighbor inside the cortex at evolution ticks only, and is left untouched otherwise.
+    // Random numbers are only ever consumed by evolution, so the stream is fully defined by the sequence of evolution ticks.
+    BHM_RAND_MODE_EVOL = 0x400001U,
+    // Random numbers are a pure hash of the neuron's random state, used as a fixed seed, the neuron's index, the tick and the neighbor,
+    // so random states never advance and every random number can be drawn independently from all others, regardless of the order
+    // neurons and neighbors are visited in.
+    BHM_RAND_MODE_COUNTER = 0x400002U
+} bhm_rand_mode_t;
+
+typedef enum {
+    // Neighbors are integrated one at a time, in neighborhood order: the value is clamped to the recovery value after each neighbor
+    // and wraps to its 16 bits range after each neighbor as well.
+    BHM_INTEGRATION_MODE_SEQUENTIAL = 0x500000U,
+    // All neighbors are integrated at once by counting bits in the synapse masks: active synapses from firing neighbors are split into
+    // excitatory and inhibitory ones, each weighing 1, or 2 if the highest bit of its strength is set, and their weighted difference is
+    // multiplied by the cortex' excitation value.
+    // The sum is computed without wrapping and added to the neuron's value, then clamped to the recovery value once, on the result only,
+    // as long as at least one neighbor was integrated.
+    // This differs from SEQUENTIAL whenever the value would dip under the recovery value midway and then come back up.
+    BHM_INTEGRATION_MODE_POPCOUNT = 0x500001U
+} bhm_integration_mode_t;
+
+typedef enum {
+    // Each part of neuron storage is first written by the thread that ticks it, in the same tile partition ticks use,
+    // so that the OS places it in that thread's NUMA node. Only effective as long as threads don't migrate between nodes (see bhm_pin_threads).
+    BHM_NUMA_POLICY_FIRST_TOUCH = 0x600000U,
+    // Neuron storage is interleaved page by page among all NUMA nodes. Requires behema to be built with libnuma (NUMA=1).
+    BHM_NUMA_POLICY_INTERLEAVE = 0x600001U
+} bhm_numa_policy_t;
+
+typedef enum {
+    // Neuron storage is backed by regular pages.
+    BHM_PAGE_MODE_BASE = 0x700000U,
+    // Neuron storage is aligned to huge pages and the OS is advised to back it with transparent huge pages, if enabled on the system.
+    BHM_PAGE_MODE_TRANSPARENT_HUGE = 0x700001U,
+    // Neuron storage is backed by huge pages reserved in advance by the system (see /proc/sys/vm/nr_hugepages),
+    // falling back to transparent huge pages if none are left.
+    BHM_PAGE_MODE_EXPLICIT_HUGE = 0x700002U
+} bhm_page_mode_t;
+
+typedef enum {
+    // Neighborhoods are cut at the cortex' edges: positions past them hold no neurons, so they never fire.
+    BHM_BOUNDARY_MODE_OPEN = 0x800000U,
+    // The cortex wraps around at its edges (pacman effect): neighborhoods crossing an edge continue from the opposite one.
+    BHM_BOUNDARY_MODE_TORUS = 0x800001U
+} bhm_boundary_mode_t;
+
+typedef enum {
+    // Neurons are stored row by row.
+    BHM_LAYOUT_ROW_MAJOR = 0x900000U,
+    // Rows are grouped into bands [BHM_BRICK_SIDE] rows tall, each made of square bricks [BHM_BRICK_SIDE] neurons wide stored one after the other,
+    // each holding its neurons row by row. Bricks at the right and bottom edges are cut to the cortex' size, so that no storage is wasted.
+    // Neighborhoods then fall within a few nearby bricks instead of spanning rows a whole cortex width apart, at the cost of SIMD ticks,
+    // which need whole rows to be contiguous.
+    BHM_LAYOUT_BRICK = 0x900001U
+} bhm_layout_t;
+
 /// @brief Convenience data structure for input handling (cortex feeding).
 typedef struct {
     bhm_cortex_size_t x0;
@@ -199,6 +324,70 @@ typedef struct {
     bhm_chance_t inhexc_ratio;
 } bhm_neuron_t;
 
+/// @brief Structure-of-arrays neuron storage: the nth item of each array belongs to the nth neuron of the cortex.
+/// Refer to bhm_neuron_t for the meaning of each property.
+/// Splitting properties allows the tick to only load what it needs from neighbors (value and pulse) instead of whole neurons.
+/// Arrays are split into static state (synapses and configuration), which only changes on evolution ticks and can be shared between cortices,
+/// and dynamic state (random state, pulse mask, pulse and value), which every tick rewrites.
+typedef struct {
+    // Static state.
+    bhm_nh_mask_t* synac_mask;
+    bhm_nh_mask_t* synex_mask;
+    bhm_nh_mask_t* synstr_mask_a;
+    bhm_nh_mask_t* synstr_mask_b;
+    bhm_nh_mask_t* synstr_mask_c;
+    bhm_syn_count_t* max_syn_count;
+    bhm_syn_count_t* syn_count;
+    bhm_syn_strength_t* tot_syn_strength;
+    bhm_chance_t* inhexc_ratio;
+
+    // Amount of SoA storages sharing the static state, which is freed along with the last of them.
+    uint32_t* static_refs;
+
+    // Dynamic state.
+    bhm_rand_state_t* rand_state;
+    bhm_pulse_mask_t* pulse_mask;
+    bhm_ticks_count_t* pulse;
+    bhm_neuron_value_t* value;
+} bhm_neurons_soa_t;
+
+/// @brief Bitmap telling which neurons of a cortex have their value over the cortex' fire threshold, one bit per neuron.
+/// Rows are surrounded by a ghost border: one word left of each row, one word right of it and [ghost_rows] rows above and below the cortex,
+/// mirroring the positions past the cortex' edges according to its boundary mode, so that neighborhoods can be read without checking bounds.
+typedef struct {
+    // Bit x % 64 of word x / 64 of each row is set if the neuron at column x is over threshold.
+    // Points to the first word of row 0: ghost words and rows lie at negative indexes and past the last column and row.
+    // One extra word is allocated past the last ghost row, so that any two consecutive words can be read.
+    bhm_fired_word_t* words;
+    // Amount of words per row holding neurons: rows never share words, so that different rows can be written in parallel.
+    bhm_cortex_size_t row_words;
+    // Distance between consecutive rows, in words, ghost words included.
+    bhm_cortex_size_t row_stride;
+    // Amount of ghost rows above and below the cortex, as many as its neighborhood radius.
+    bhm_cortex_size_t ghost_rows;
+    // Whether the bitmap matches the current values and fire threshold of its cortex or not.
+    bhm_bool_t valid;
+    // Whether the ghost border matches the current bitmap or not.
+    bhm_bool_t ghosts_valid;
+} bhm_fired_bitmap_t;
+
+/// @brief Activity of the tiles of a cortex, used by event-driven ticks to skip quiescent tiles.
+typedef struct {
+    // Amount of tiles along each dimension.
+    bhm_cortex_size_t width;
+    bhm_cortex_size_t height;
+    // Activity flags of each tile (BHM_TILE_*), stored row by row.
+    bhm_byte* flags;
+    // Whether flags match the current state of their cortex or not.
+    bhm_bool_t valid;
+    // Incremented at every change to the cortex' neurons.
+    uint64_t version;
+    // Cortex this one was last ticked from, along with its version at the time.
+    // Clean flags only hold as long as the source cortex is still at the same version.
+    const void* source;
+    uint64_t source_version;
+} bhm_tile_events_t;
+
 /// @brief 2D cortex of neurons.
 typedef struct {
     // Width of the cortex.
@@ -254,7 +443,47 @@ typedef struct {
     bhm_ticks_count_t sample_window;
     bhm_pulse_mapping_t pulse_mapping;
 
+    // Layout of neurons in memory: neurons are stored in [neurons] in AOS mode and in [soa] in SOA mode.
+    // The unused storage is always left empty.
+    bhm_storage_mode_t storage_mode;
+
+    // Order neurons are stored in, in both storage modes.
+    bhm_layout_t layout;
+
+    // Kernel used to tick the cortex.
+    bhm_tick_mode_t tick_mode;
+
+    // Random stream used by neurons.
+    bhm_rand_mode_t rand_mode;
+
+    // How neighbors' influence is summed up during ticks.
+    bhm_integration_mode_t integration_mode;
+
+    // What lies past the cortex' edges.
+    bhm_boundary_mode_t boundary_mode;
+
+    // Size of the tiles ticks are split into: each tile is updated as a whole by a single thread, so that its rows and their halo stay in cache.
+    // The tile width is always a multiple of 64, so that tiles never share fired bitmap words.
+    bhm_cortex_size_t tile_width;
+    bhm_cortex_size_t tile_height;
+
+    // How neuron storage is placed among NUMA nodes.
+    bhm_numa_policy_t numa_policy;
+
+    // Which pages neuron storage is backed by, and the size of the pages it actually got, the smallest among its arrays.
+    // Arrays smaller than a huge page are always backed by regular pages.
+    bhm_page_mode_t page_mode;
+    size_t page_size;
+
+    // Fired bitmap, published by each tick for the next one to read neighbors' firing state from.
+    // It's kept up to date by all library functions, direct writes to neuron values should go through c2d_set_neuron.
+    bhm_fired_bitmap_t fired;
+
+    // Tiles activity, kept up to date by ticks and inputs for the next event-driven tick to skip quiescent tiles.
+    bhm_tile_events_t events;
+
     bhm_neuron_t* neurons;
+    bhm_neurons_soa_t soa;
 } bhm_cortex2d_t;
 
 /// @brief 3D cortex of neurons.
@@ -275,6 +504,161 @@ typedef struct {
 /// Marsiglia's xorshift pseudo-random number generator with period 2^32-1.
 uint32_t xorshf32(uint32_t state);
 
+/// @brief Inline variant of xorshf32, for hot loops outside of cortex.c.
+static inline uint32_t xorshf32_inline(uint32_t state) {
+    // Algorithm "xor" from p. 4 of Marsaglia, "Xorshift RNGs".
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/// @brief Murmur3's 32 bit finalizer, used to turn counters into random numbers.
+static inline uint32_t mix32_inline(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6BU;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35U;
+    x ^= x >> 16;
+    return x;
+}
+
+/// @brief Computes the key all random numbers drawn by a neuron at a given tick derive from, as defined by BHM_RAND_MODE_COUNTER.
+/// @param seed The neuron's random state.
+/// @param index The neuron's index in the cortex.
+/// @param tick The cortex' ticks count.
+static inline uint32_t counter_key(uint32_t seed, uint32_t index, uint32_t tick) {
+    return mix32_inline(mix32_inline(seed ^ mix32_inline(index)) + tick);
+}
+
+/// @brief Draws the random number for neighborhood slot [slot] from the provided counter key.
+static inline uint32_t counter_rand(uint32_t key, uint32_t slot) {
+    return mix32_inline(key + slot * 0x9E3779B9U);
+}
+
+/// @brief Gathers the neuron at [index] from the provided SoA storage.
+static inline void soa_load_neuron(
+    const bhm_neurons_soa_t* soa,
+    bhm_cortex_size_t index,
+    bhm_neuron_t* neuron
+) {
+    neuron->synac_mask = soa->synac_mask[index];
+    neuron->synex_mask = soa->synex_mask[index];
+    neuron->synstr_mask_a = soa->synstr_mask_a[index];
+    neuron->synstr_mask_b = soa->synstr_mask_b[index];
+    neuron->synstr_mask_c = soa->synstr_mask_c[index];
+    neuron->rand_state = soa->rand_state[index];
+    neuron->pulse_mask = soa->pulse_mask[index];
+    neuron->pulse = soa->pulse[index];
+    neuron->value = soa->value[index];
+    neuron->max_syn_count = soa->max_syn_count[index];
+    neuron->syn_count = soa->syn_count[index];
+    neuron->tot_syn_strength = soa->tot_syn_strength[index];
+    neuron->inhexc_ratio = soa->inhexc_ratio[index];
+}
+
+/// @brief Scatters the static state (synapses and configuration) of the provided neuron to [index] in the provided SoA storage.
+static inline void soa_store_static(
+    bhm_neurons_soa_t* soa,
+    bhm_cortex_size_t index,
+    const bhm_neuron_t* neuron
+) {
+    soa->synac_mask[index] = neuron->synac_mask;
+    soa->synex_mask[index] = neuron->synex_mask;
+    soa->synstr_mask_a[index] = neuron->synstr_mask_a;
+    soa->synstr_mask_b[index] = neuron->synstr_mask_b;
+    soa->synstr_mask_c[index] = neuron->synstr_mask_c;
+    soa->max_syn_count[index] = neuron->max_syn_count;
+    soa->syn_count[index] = neuron->syn_count;
+    soa->tot_syn_strength[index] = neuron->tot_syn_strength;
+    soa->inhexc_ratio[index] = neuron->inhexc_ratio;
+}
+
+/// @brief Scatters the dynamic state (random state, pulse mask, pulse and value) of the provided neuron to [index] in the provided SoA storage.
+static inline void soa_store_dynamic(
+    bhm_neurons_soa_t* soa,
+    bhm_cortex_size_t index,
+    const bhm_neuron_t* neuron
+) {
+    soa->rand_state[index] = neuron->rand_state;
+    soa->pulse_mask[index] = neuron->pulse_mask;
+    soa->pulse[index] = neuron->pulse;
+    soa->value[index] = neuron->value;
+}
+
+/// @brief Scatters the provided neuron to [index] in the provided SoA storage.
+static inline void soa_store_neuron(
+    bhm_neurons_soa_t* soa,
+    bhm_cortex_size_t index,
+    const bhm_neuron_t* neuron
+) {
+    soa_store_static(soa, index, neuron);
+    soa_store_dynamic(soa, index, neuron);
+}
+
+/// @brief Tells whether the two provided SoA storages share their static state or not.
+static inline bhm_bool_t soa_shares_static(
+    const bhm_neurons_soa_t* a,
+    const bhm_neurons_soa_t* b
+) {
+    return a->static_refs != NULL && a->static_refs == b->static_refs;
+}
+
+/// @brief Computes the amount of tiles the provided cortex is split into along each dimension, given its tile size.
+static inline void c2d_tiles_count(const bhm_cortex2d_t* cortex, bhm_cortex_size_t* tiles_width, bhm_cortex_size_t* tiles_height) {
+    *tiles_width = (cortex->width + cortex->tile_width - 1) / cortex->tile_width;
+    *tiles_height = (cortex->height + cortex->tile_height - 1) / cortex->tile_height;
+}
+
+/// @brief Computes the bounds [x0, x1) x [y0, y1) of tile [tx, ty] of the provided cortex, given its tile size.
+static inline void c2d_tile_bounds(
+    const bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t tx,
+    bhm_cortex_size_t ty,
+    bhm_cortex_size_t* x0,
+    bhm_cortex_size_t* y0,
+    bhm_cortex_size_t* x1,
+    bhm_cortex_size_t* y1
+) {
+    *x0 = tx * cortex->tile_width;
+    *y0 = ty * cortex->tile_height;
+    *x1 = *x0 + cortex->tile_width < cortex->width ? *x0 + cortex->tile_width : cortex->width;
+    *y1 = *y0 + cortex->tile_height < cortex->height ? *y0 + cortex->tile_height : cortex->height;
+}
+
+/// @brief Computes the storage index of the neuron at [x, y] of a [width] x [height] cortex stored in the provided layout.
+static inline bhm_cortex_size_t layout_index(
+    bhm_layout_t layout,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y
+) {
+    if (layout == BHM_LAYOUT_ROW_MAJOR) {
+        return IDX2D(x, y, width);
+    }
+
+    // Bands before the neuron's are always full height, and so are bricks before its own in the band.
+    bhm_cortex_size_t band_y = y - y % BHM_BRICK_SIDE;
+    bhm_cortex_size_t brick_x = x - x % BHM_BRICK_SIDE;
+    bhm_cortex_size_t band_height = height - band_y < BHM_BRICK_SIDE ? height - band_y : BHM_BRICK_SIDE;
+    bhm_cortex_size_t brick_width = width - brick_x < BHM_BRICK_SIDE ? width - brick_x : BHM_BRICK_SIDE;
+
+    return band_y * width + brick_x * band_height + IDX2D(x % BHM_BRICK_SIDE, y % BHM_BRICK_SIDE, brick_width);
+}
+
+/// @brief Computes the storage index of the neuron at [x, y] of the provided cortex.
+static inline bhm_cortex_size_t c2d_neuron_index(const bhm_cortex2d_t* cortex, bhm_cortex_size_t x, bhm_cortex_size_t y) {
+    return layout_index(cortex->layout, cortex->width, cortex->height, x, y);
+}
+
+/// @brief Marks the provided tiles activity as out of date, after its cortex' neurons changed outside of ticks.
+static inline void events_invalidate(bhm_tile_events_t* events) {
+    events->valid = BHM_FALSE;
+    events->version++;
+}
+
 
 // ##########################################
 // Initialization functions.
@@ -372,6 +756,14 @@ bhm_error_code_t o2d_destroy(
     bhm_output2d_t* output
 );
 
+/// @brief Frees memory for the neurons of the given cortex, whatever storage they're in, along with its fired bitmap and tiles activity,
+/// but not for the cortex itself. Useful for cortices not allocated by c2d_alloc, such as the ones of a population.
+/// @param cortex The cortex to deinitialize.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_deinit(
+    bhm_cortex2d_t* cortex
+);
+
 /// @brief Destroys the given cortex2d and frees memory for it and its neurons.
 /// @param cortex The cortex to destroy
 /// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
@@ -382,12 +774,28 @@ bhm_error_code_t c2d_destroy(
 /// @brief Returns a cortex with the same properties as the given one.
 /// @param to The destination cortex.
 /// @param from The source cortex.
-/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none,
+/// [BHM_ERROR_STORAGE_MODE_WRONG] if the two cortices have different storage modes or layouts.
 bhm_error_code_t c2d_copy(
     bhm_cortex2d_t* to,
     bhm_cortex2d_t* from
 );
 
+/// @brief Makes [to] share the static neuron state (synapses and configuration) of [from], while keeping its own dynamic state.
+/// Meant for the two cortices of a double buffer, which then only hold one copy of synapses between them: ticks between the two
+/// only write dynamic state, plus synapse changes on evolution ticks, which are committed in place neuron by neuron.
+/// Synapse changes applied to either cortex are seen by both from then on.
+/// Moving either cortex' storage through c2d_set_layout or c2d_set_page_mode ends the sharing.
+/// @param to The cortex to share static state with [from].
+/// @param from The cortex whose static state is shared.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+/// [BHM_ERROR_STORAGE_MODE_WRONG] if either cortex is not in SOA storage mode or the two have different layouts,
+/// [BHM_ERROR_SIZE_WRONG] if cortices have different sizes.
+bhm_error_code_t c2d_share_static(
+    bhm_cortex2d_t* to,
+    bhm_cortex2d_t* from
+);
+
 // ##########################################
 // ##########################################
 
@@ -503,6 +911,114 @@ bhm_error_code_t c2d_syn_disable(
     bhm_cortex_size_t y1
 );
 
+/// @brief Sets the memory layout of the cortex' neurons, converting the existing neurons to the new layout.
+/// SOA mode makes the tick only touch neighbors' value and pulse, which greatly reduces memory traffic on big cortices.
+/// Shape mutations (rows and columns insertion, removal and transposition) are only supported in AOS mode.
+/// @param cortex The cortex to edit.
+/// @param storage_mode The storage mode to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_storage_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_storage_mode_t storage_mode
+);
+
+/// @brief Sets the kernel used to tick the cortex.
+/// @param cortex The cortex to edit.
+/// @param tick_mode The tick mode to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_tick_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_tick_mode_t tick_mode
+);
+
+/// @brief Sets the random stream used by the cortex' neurons.
+/// Switching between modes changes the random numbers drawn at later evolutions, so it should be done before the cortex is first ticked.
+/// @param cortex The cortex to edit.
+/// @param rand_mode The rand mode to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_rand_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_rand_mode_t rand_mode
+);
+
+/// @brief Sets how neighbors' influence is summed up during ticks.
+/// @param cortex The cortex to edit.
+/// @param integration_mode The integration mode to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_integration_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_integration_mode_t integration_mode
+);
+
+/// @brief Sets what lies past the cortex' edges: either nothing, or the opposite edges of the cortex.
+/// @param cortex The cortex to edit.
+/// @param boundary_mode The boundary mode to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_boundary_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_boundary_mode_t boundary_mode
+);
+
+/// @brief Sets the order the cortex' neurons are stored in, reordering the existing neurons into newly allocated storage.
+/// Should be set right after initialization, before any copies are made, since double buffered cortices need to share the same layout.
+/// Static state shared with another cortex (see c2d_share_static) is moved as well: the two stop sharing it, each then holding its own copy,
+/// until c2d_share_static is called again.
+/// @param cortex The cortex to edit.
+/// @param layout The layout to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_layout(
+    bhm_cortex2d_t* cortex,
+    bhm_layout_t layout
+);
+
+/// @brief Sets the size of the tiles ticks are split into. Each tile is updated by a single thread, so tiles should be small enough for
+/// their rows and halo to stay in the L2 cache, while still being many more than threads.
+/// @param cortex The cortex to edit.
+/// @param tile_width The width of the tiles, must be a positive multiple of 64.
+/// @param tile_height The height of the tiles, must be positive.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_tile_size(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t tile_width,
+    bhm_cortex_size_t tile_height
+);
+
+/// @brief Sets how the cortex' neuron storage is placed among NUMA nodes, moving it accordingly if behema is built with libnuma (NUMA=1).
+/// Without libnuma, only BHM_NUMA_POLICY_FIRST_TOUCH is available, and it only applies to storage allocated from then on.
+/// @param cortex The cortex to edit.
+/// @param numa_policy The NUMA policy to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+/// [BHM_ERROR_NOT_SUPPORTED] if the policy is not available in the current build or on the current system.
+bhm_error_code_t c2d_set_numa_policy(
+    bhm_cortex2d_t* cortex,
+    bhm_numa_policy_t numa_policy
+);
+
+/// @brief Sets which pages back the cortex' neuron storage, moving it to newly allocated storage. The size of the pages actually obtained
+/// is then available in the cortex' page size.
+/// Static state shared with another cortex (see c2d_share_static) is moved as well: the two stop sharing it, each then holding its own copy,
+/// until c2d_share_static is called again.
+/// @param cortex The cortex to edit.
+/// @param page_mode The page mode to apply.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_page_mode(
+    bhm_cortex2d_t* cortex,
+    bhm_page_mode_t page_mode
+);
+
+/// @brief Overwrites the neuron at the provided coordinates, regardless of the cortex' storage mode.
+/// @param cortex The cortex to edit.
+/// @param x The column of the neuron to overwrite.
+/// @param y The row of the neuron to overwrite.
+/// @param neuron The neuron to copy into the cortex.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_set_neuron(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_neuron_t* neuron
+);
+
 /// @brief Randomly mutates the cortex shape.
 /// @param cortex The cortex to edit.
 /// @param mut_chance The probability of applying a mutation to the cortex shape.
@@ -547,6 +1063,19 @@ bhm_error_code_t c2d_to_string(
     char* result
 );
 
+/// @brief Copies the neuron at the provided coordinates to [neuron], regardless of the cortex' storage mode.
+/// @param cortex The cortex to read from.
+/// @param x The column of the neuron to read.
+/// @param y The row of the neuron to read.
+/// @param neuron The neuron to fill with the cortex' neuron data.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t c2d_get_neuron(
+    bhm_cortex2d_t* cortex,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_neuron_t* neuron
+);
+
 /// @brief Computes the mean value of an input2d's values.
 /// @param input The input to compute the mean value from.
 /// @param result Pointer to the result of the computation. The mean value will be stored here.
@@ -573,6 +1102,97 @@ bhm_error_code_t o2d_mean(
 // Utility functions
 // ##########################################
 
+/// @brief Allocates neuron storage, aligned to BHM_STORAGE_ALIGNMENT and backed by the pages requested.
+/// Storage allocated this way must be freed through storage_free.
+/// @param storage Pointer to the newly allocated storage, left NULL on failure.
+/// @param size The size of the storage, in bytes.
+/// @param page_mode Which pages to back the storage with.
+/// @param page_size Where the size of the pages actually backing the storage is stored, may be NULL.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t storage_alloc(
+    void** storage,
+    size_t size,
+    bhm_page_mode_t page_mode,
+    size_t* page_size
+);
+
+/// @brief Frees storage allocated through storage_alloc. Does nothing if [storage] is NULL.
+/// @param storage The storage to free.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t storage_free(
+    void* storage
+);
+
+/// @brief Allocates SoA storage for the provided amount of neurons.
+/// @param soa The SoA storage to allocate.
+/// @param count The amount of neurons to allocate room for.
+/// @param page_mode Which pages to back the storage with.
+/// @param page_size Where the smallest size of the pages actually backing the storage is stored, may be NULL.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t soa_alloc(
+    bhm_neurons_soa_t* soa,
+    bhm_cortex_size_t count,
+    bhm_page_mode_t page_mode,
+    size_t* page_size
+);
+
+/// @brief Frees all arrays in the provided SoA storage.
+/// @param soa The SoA storage to free.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t soa_free(
+    bhm_neurons_soa_t* soa
+);
+
+/// @brief Makes [to] share the static state (synapses and configuration) of [from], releasing its own while keeping its dynamic state.
+/// Both storages must hold the same amount of neurons.
+/// @param to The SoA storage to share static state with [from].
+/// @param from The SoA storage whose static state is shared.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t soa_share_static(
+    bhm_neurons_soa_t* to,
+    bhm_neurons_soa_t* from
+);
+
+/// @brief Allocates the provided fired bitmap for a cortex of the given size, releasing any previous allocation.
+/// The newly allocated bitmap is left invalid, so that it's rebuilt before being read.
+/// @param fired The fired bitmap to allocate.
+/// @param width The width of the cortex the bitmap is for.
+/// @param height The height of the cortex the bitmap is for.
+/// @param nh_radius The neighborhood radius of the cortex the bitmap is for, telling how many ghost rows to surround it with.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t fired_alloc(
+    bhm_fired_bitmap_t* fired,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_nh_radius_t nh_radius
+);
+
+/// @brief Frees the provided fired bitmap.
+/// @param fired The fired bitmap to free.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t fired_free(
+    bhm_fired_bitmap_t* fired
+);
+
+/// @brief Allocates the provided tiles activity for a cortex of the given size, releasing any previous allocation.
+/// The newly allocated activity is left invalid, so that the next tick is run in full.
+/// @param events The tiles activity to allocate.
+/// @param width The width of the cortex the tiles activity is for.
+/// @param height The height of the cortex the tiles activity is for.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t events_alloc(
+    bhm_tile_events_t* events,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height
+);
+
+/// @brief Frees the provided tiles activity.
+/// @param events The tiles activity to free.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t events_free(
+    bhm_tile_events_t* events
+);
+
 /// @brief Adds a row of neurons at the provided index.
 /// @param cortex The cortex to add a row to.
 /// @param index The index at which to add the new row of neurons.
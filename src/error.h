@@ -9,7 +9,9 @@ typedef enum {
     BHM_ERROR_FAILED_ALLOC = 4,
     BHM_ERROR_CORTEX_UNALLOC = 5,
     BHM_ERROR_SIZE_WRONG = 6,
-    BHM_ERROR_EXTERNAL_CAUSES = 7
+    BHM_ERROR_EXTERNAL_CAUSES = 7,
+    BHM_ERROR_STORAGE_MODE_WRONG = 8,
+    BHM_ERROR_NOT_SUPPORTED = 9
 } bhm_error_code_t;
 
 #endif
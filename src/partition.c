@@ -0,0 +1,738 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "partition.h"
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define __BHM_POSIX__
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <sched.h>
+#endif
+
+
+// ##########################################
+// Transport functions
+// ##########################################
+
+#ifdef __BHM_POSIX__
+
+/// @brief Waits a little before retrying to reach other processes.
+static void transport_retry_wait(void) {
+    struct timespec wait = {0, BHM_TRANSPORT_RETRY_NS};
+    nanosleep(&wait, NULL);
+}
+
+// Tells that the shared memory segment has been set up by the process ranked 0.
+#define BHM_SHM_READY 0x42484D31U
+
+/// @brief Header of a shared memory segment, followed by one channel from each process to each other process.
+typedef struct {
+    _Atomic uint32_t ready;
+    uint32_t ranks_count;
+    uint64_t capacity;
+} bhm_shm_header_t;
+
+/// @brief Single-slot channel from one process to another, followed by [capacity] bytes of data.
+/// The slot is full whenever more chunks have been sent than received.
+typedef struct {
+    _Atomic uint64_t sent;
+    _Atomic uint64_t received;
+    // Size of the chunk in the slot.
+    uint64_t size;
+} bhm_shm_channel_t;
+
+/// @brief State of a shared memory transport.
+typedef struct {
+    bhm_byte* base;
+    size_t length;
+    size_t capacity;
+    // Distance between consecutive channels, in bytes.
+    size_t channel_stride;
+    char* name;
+} bhm_shm_state_t;
+
+// Header and channels are kept apart in different cache lines.
+#define BHM_SHM_ALIGNMENT 0x40U
+
+static bhm_shm_channel_t* shm_channel(const bhm_transport_t* transport, uint32_t from_rank, uint32_t to_rank) {
+    const bhm_shm_state_t* state = (const bhm_shm_state_t*) transport->state;
+    size_t index = (size_t) from_rank * transport->ranks_count + to_rank;
+    return (bhm_shm_channel_t*) (state->base + BHM_SHM_ALIGNMENT + index * state->channel_stride);
+}
+
+static bhm_error_code_t shm_send(bhm_transport_t* transport, uint32_t to_rank, const void* data, size_t size) {
+    const bhm_shm_state_t* state = (const bhm_shm_state_t*) transport->state;
+    bhm_shm_channel_t* channel = shm_channel(transport, transport->rank, to_rank);
+    bhm_byte* slot = (bhm_byte*) channel + BHM_SHM_ALIGNMENT;
+
+    // Split the message into chunks that fit the slot.
+    for (size_t offset = 0; offset < size || (size == 0 && offset == 0); ) {
+        uint64_t sent = atomic_load_explicit(&(channel->sent), memory_order_relaxed);
+
+        // Wait for the receiver to empty the slot.
+        while (atomic_load_explicit(&(channel->received), memory_order_acquire) != sent) {
+            sched_yield();
+        }
+
+        size_t chunk_size = size - offset < state->capacity ? size - offset : state->capacity;
+        memcpy(slot, (const bhm_byte*) data + offset, chunk_size);
+        channel->size = chunk_size;
+        atomic_store_explicit(&(channel->sent), sent + 1, memory_order_release);
+
+        offset += chunk_size;
+        if (size == 0) {
+            break;
+        }
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+static bhm_error_code_t shm_recv(bhm_transport_t* transport, uint32_t from_rank, void* data, size_t size) {
+    bhm_shm_channel_t* channel = shm_channel(transport, from_rank, transport->rank);
+    const bhm_byte* slot = (const bhm_byte*) channel + BHM_SHM_ALIGNMENT;
+
+    for (size_t offset = 0; offset < size || (size == 0 && offset == 0); ) {
+        uint64_t received = atomic_load_explicit(&(channel->received), memory_order_relaxed);
+
+        // Wait for the sender to fill the slot.
+        while (atomic_load_explicit(&(channel->sent), memory_order_acquire) == received) {
+            sched_yield();
+        }
+
+        size_t chunk_size = channel->size;
+        if (offset + chunk_size > size) {
+            return BHM_ERROR_SIZE_WRONG;
+        }
+        memcpy((bhm_byte*) data + offset, slot, chunk_size);
+        atomic_store_explicit(&(channel->received), received + 1, memory_order_release);
+
+        offset += chunk_size;
+        if (size == 0) {
+            break;
+        }
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+static void shm_close(bhm_transport_t* transport) {
+    bhm_shm_state_t* state = (bhm_shm_state_t*) transport->state;
+    if (state == NULL) {
+        return;
+    }
+
+    if (state->base != NULL) {
+        munmap(state->base, state->length);
+    }
+
+    // The segment outlives its name, so it can be unlinked as soon as the creator is done with it.
+    if (transport->rank == 0 && state->name != NULL) {
+        shm_unlink(state->name);
+    }
+
+    free(state->name);
+    free(state);
+    transport->state = NULL;
+}
+
+#endif
+
+bhm_error_code_t transport_shm_create(
+    bhm_transport_t** transport,
+    const char* name,
+    uint32_t rank,
+    uint32_t ranks_count,
+    size_t capacity
+) {
+#ifdef __BHM_POSIX__
+    if (rank >= ranks_count || capacity <= 0) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    // Allocate the transport.
+    (*transport) = (bhm_transport_t*) malloc(sizeof(bhm_transport_t));
+    if ((*transport) == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    bhm_shm_state_t* state = (bhm_shm_state_t*) calloc(1, sizeof(bhm_shm_state_t));
+    char* state_name = (char*) malloc(strlen(name) + 1);
+    if (state == NULL || state_name == NULL) {
+        free(state);
+        free(state_name);
+        free(*transport);
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    strcpy(state_name, name);
+
+    (*transport)->rank = rank;
+    (*transport)->ranks_count = ranks_count;
+    (*transport)->send = shm_send;
+    (*transport)->recv = shm_recv;
+    (*transport)->close = shm_close;
+    (*transport)->state = state;
+
+    state->name = state_name;
+    state->capacity = capacity;
+    state->channel_stride = BHM_SHM_ALIGNMENT + (capacity + BHM_SHM_ALIGNMENT - 1) / BHM_SHM_ALIGNMENT * BHM_SHM_ALIGNMENT;
+    state->length = BHM_SHM_ALIGNMENT + (size_t) ranks_count * ranks_count * state->channel_stride;
+
+    int fd = -1;
+    if (rank == 0) {
+        // Drop any segment left behind by a previous run, so that channels start empty.
+        shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0 && ftruncate(fd, state->length) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        // Wait for the segment to be created and sized.
+        for (uint32_t attempt = 0; fd < 0 && attempt < BHM_TRANSPORT_CONNECT_RETRIES; attempt++) {
+            fd = shm_open(name, O_RDWR, 0600);
+
+            struct stat info;
+            if (fd >= 0 && (fstat(fd, &info) != 0 || (size_t) info.st_size < state->length)) {
+                close(fd);
+                fd = -1;
+            }
+            if (fd < 0) {
+                transport_retry_wait();
+            }
+        }
+    }
+    if (fd < 0) {
+        transport_destroy(*transport);
+        return BHM_ERROR_EXTERNAL_CAUSES;
+    }
+
+    void* base = mmap(NULL, state->length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        transport_destroy(*transport);
+        return BHM_ERROR_EXTERNAL_CAUSES;
+    }
+    state->base = (bhm_byte*) base;
+
+    bhm_shm_header_t* header = (bhm_shm_header_t*) state->base;
+    if (rank == 0) {
+        // Newly sized segments are zero-filled, so all channels start empty.
+        header->ranks_count = ranks_count;
+        header->capacity = capacity;
+        atomic_store_explicit(&(header->ready), BHM_SHM_READY, memory_order_release);
+    } else {
+        uint32_t attempt = 0;
+        while (atomic_load_explicit(&(header->ready), memory_order_acquire) != BHM_SHM_READY && attempt++ < BHM_TRANSPORT_CONNECT_RETRIES) {
+            transport_retry_wait();
+        }
+        if (atomic_load_explicit(&(header->ready), memory_order_acquire) != BHM_SHM_READY ||
+            header->ranks_count != ranks_count || header->capacity != capacity) {
+            transport_destroy(*transport);
+            return BHM_ERROR_EXTERNAL_CAUSES;
+        }
+    }
+
+    return BHM_ERROR_NONE;
+#else
+    return BHM_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+#ifdef __BHM_POSIX__
+
+/// @brief State of a Unix domain sockets transport.
+typedef struct {
+    // Connected socket to each other process, indexed by rank.
+    int* sockets;
+} bhm_socket_state_t;
+
+/// @brief Computes the address process [rank] listens on.
+static bhm_error_code_t socket_address(struct sockaddr_un* address, const char* path, uint32_t rank) {
+    memset(address, 0, sizeof(struct sockaddr_un));
+    address->sun_family = AF_UNIX;
+    int length = snprintf(address->sun_path, sizeof(address->sun_path), "%s.%u", path, rank);
+    if (length < 0 || (size_t) length >= sizeof(address->sun_path)) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+    return BHM_ERROR_NONE;
+}
+
+static bhm_error_code_t socket_send(bhm_transport_t* transport, uint32_t to_rank, const void* data, size_t size) {
+    const bhm_socket_state_t* state = (const bhm_socket_state_t*) transport->state;
+
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+
+    for (size_t offset = 0; offset < size; ) {
+        ssize_t written = send(state->sockets[to_rank], (const bhm_byte*) data + offset, size - offset, flags);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return BHM_ERROR_EXTERNAL_CAUSES;
+        }
+        offset += written;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+static bhm_error_code_t socket_recv(bhm_transport_t* transport, uint32_t from_rank, void* data, size_t size) {
+    const bhm_socket_state_t* state = (const bhm_socket_state_t*) transport->state;
+
+    for (size_t offset = 0; offset < size; ) {
+        ssize_t read = recv(state->sockets[from_rank], (bhm_byte*) data + offset, size - offset, 0);
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        // The sending process is gone.
+        if (read <= 0) {
+            return BHM_ERROR_EXTERNAL_CAUSES;
+        }
+        offset += read;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+static void socket_close(bhm_transport_t* transport) {
+    bhm_socket_state_t* state = (bhm_socket_state_t*) transport->state;
+    if (state == NULL) {
+        return;
+    }
+
+    if (state->sockets != NULL) {
+        for (uint32_t i = 0; i < transport->ranks_count; i++) {
+            if (state->sockets[i] >= 0) {
+                close(state->sockets[i]);
+            }
+        }
+    }
+
+    free(state->sockets);
+    free(state);
+    transport->state = NULL;
+}
+
+#endif
+
+bhm_error_code_t transport_socket_create(
+    bhm_transport_t** transport,
+    const char* path,
+    uint32_t rank,
+    uint32_t ranks_count
+) {
+#ifdef __BHM_POSIX__
+    if (rank >= ranks_count) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    struct sockaddr_un address;
+    if (socket_address(&address, path, ranks_count - 1) != BHM_ERROR_NONE) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    // Allocate the transport.
+    (*transport) = (bhm_transport_t*) malloc(sizeof(bhm_transport_t));
+    if ((*transport) == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    bhm_socket_state_t* state = (bhm_socket_state_t*) malloc(sizeof(bhm_socket_state_t));
+    int* sockets = (int*) malloc(ranks_count * sizeof(int));
+    if (state == NULL || sockets == NULL) {
+        free(state);
+        free(sockets);
+        free(*transport);
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    for (uint32_t i = 0; i < ranks_count; i++) {
+        sockets[i] = -1;
+    }
+    state->sockets = sockets;
+
+    (*transport)->rank = rank;
+    (*transport)->ranks_count = ranks_count;
+    (*transport)->send = socket_send;
+    (*transport)->recv = socket_recv;
+    (*transport)->close = socket_close;
+    (*transport)->state = state;
+
+    // Listen for higher ranks before reaching lower ones, so that no process waits on another that's not listening yet.
+    int listener = -1;
+    if (rank + 1 < ranks_count) {
+        socket_address(&address, path, rank);
+        unlink(address.sun_path);
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 ||
+            bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0 ||
+            listen(listener, ranks_count) != 0) {
+            if (listener >= 0) {
+                close(listener);
+            }
+            transport_destroy(*transport);
+            return BHM_ERROR_EXTERNAL_CAUSES;
+        }
+    }
+
+    bhm_error_code_t error = BHM_ERROR_NONE;
+
+    // Connect to all lower ranks, introducing the current process to each of them.
+    for (uint32_t other = 0; other < rank && error == BHM_ERROR_NONE; other++) {
+        struct sockaddr_un other_address;
+        socket_address(&other_address, path, other);
+
+        for (uint32_t attempt = 0; sockets[other] < 0 && attempt < BHM_TRANSPORT_CONNECT_RETRIES; attempt++) {
+            int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (connection >= 0 && connect(connection, (struct sockaddr*) &other_address, sizeof(other_address)) == 0) {
+                sockets[other] = connection;
+            } else {
+                if (connection >= 0) {
+                    close(connection);
+                }
+                transport_retry_wait();
+            }
+        }
+
+        if (sockets[other] < 0) {
+            error = BHM_ERROR_EXTERNAL_CAUSES;
+        } else {
+            error = socket_send(*transport, other, &rank, sizeof(rank));
+        }
+    }
+
+    // Accept all higher ranks, which introduce themselves first.
+    for (uint32_t i = rank + 1; i < ranks_count && error == BHM_ERROR_NONE; i++) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            error = BHM_ERROR_EXTERNAL_CAUSES;
+            break;
+        }
+
+        uint32_t other;
+        ssize_t read = recv(connection, &other, sizeof(other), MSG_WAITALL);
+        if (read != sizeof(other) || other <= rank || other >= ranks_count || sockets[other] >= 0) {
+            close(connection);
+            error = BHM_ERROR_EXTERNAL_CAUSES;
+            break;
+        }
+        sockets[other] = connection;
+    }
+
+    // Everyone is connected, so the listening socket is no longer needed.
+    if (listener >= 0) {
+        close(listener);
+        socket_address(&address, path, rank);
+        unlink(address.sun_path);
+    }
+
+    if (error != BHM_ERROR_NONE) {
+        transport_destroy(*transport);
+        return error;
+    }
+
+    return BHM_ERROR_NONE;
+#else
+    return BHM_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+bhm_error_code_t transport_destroy(
+    bhm_transport_t* transport
+) {
+    if (transport->close != NULL) {
+        transport->close(transport);
+    }
+
+    free(transport);
+
+    return BHM_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Slab functions
+// ##########################################
+
+/// @brief Copies [rows] whole rows from row [from_y] of [from] to row [to_y] of [to], which must have the same width.
+static void c2d_copy_rows(
+    bhm_cortex2d_t* to,
+    bhm_cortex_size_t to_y,
+    bhm_cortex2d_t* from,
+    bhm_cortex_size_t from_y,
+    bhm_cortex_size_t rows
+) {
+    #pragma omp parallel for schedule(static)
+    for (bhm_cortex_size_t y = 0; y < rows; y++) {
+        for (bhm_cortex_size_t x = 0; x < from->width; x++) {
+            bhm_neuron_t neuron;
+            c2d_get_neuron(from, x, from_y + y, &neuron);
+
+            bhm_cortex_size_t index = c2d_neuron_index(to, x, to_y + y);
+            if (to->storage_mode == BHM_STORAGE_MODE_SOA) {
+                soa_store_neuron(&(to->soa), index, &neuron);
+            } else {
+                to->neurons[index] = neuron;
+            }
+        }
+    }
+
+    to->fired.valid = BHM_FALSE;
+    events_invalidate(&(to->events));
+}
+
+bhm_error_code_t s2d_create(
+    bhm_slab2d_t** slab,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_nh_radius_t nh_radius,
+    bhm_transport_t* transport
+) {
+    uint32_t rank = transport->rank;
+    uint32_t ranks_count = transport->ranks_count;
+
+    // Halos are only taken from adjacent slabs, so no slab can be thinner than a halo.
+    if (height / (bhm_cortex_size_t) ranks_count < nh_radius || height / (bhm_cortex_size_t) ranks_count <= 0) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    // Allocate the slab.
+    (*slab) = (bhm_slab2d_t*) malloc(sizeof(bhm_slab2d_t));
+    if ((*slab) == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    // Split rows evenly.
+    (*slab)->width = width;
+    (*slab)->height = height;
+    (*slab)->nh_radius = nh_radius;
+    (*slab)->y0 = (bhm_cortex_size_t) (((int64_t) height * rank) / ranks_count);
+    (*slab)->y1 = (bhm_cortex_size_t) (((int64_t) height * (rank + 1)) / ranks_count);
+    (*slab)->halo_top = rank > 0 ? nh_radius : 0;
+    (*slab)->halo_bottom = rank + 1 < ranks_count ? nh_radius : 0;
+    (*slab)->transport = transport;
+    (*slab)->cortex = NULL;
+
+    // Each halo message holds the values and pulses of [nh_radius] rows.
+    size_t halo_size = (size_t) nh_radius * width * (sizeof(bhm_neuron_value_t) + sizeof(bhm_ticks_count_t));
+    (*slab)->send_buffer = (bhm_byte*) malloc(halo_size);
+    (*slab)->recv_buffer = (bhm_byte*) malloc(halo_size);
+    if ((*slab)->send_buffer == NULL || (*slab)->recv_buffer == NULL) {
+        s2d_destroy(*slab);
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    bhm_error_code_t error = c2d_create(
+        &((*slab)->cortex),
+        width,
+        (*slab)->halo_top + ((*slab)->y1 - (*slab)->y0) + (*slab)->halo_bottom,
+        nh_radius
+    );
+    if (error != BHM_ERROR_NONE) {
+        s2d_destroy(*slab);
+        return error;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t s2d_destroy(
+    bhm_slab2d_t* slab
+) {
+    // Free neurons.
+    if (slab->cortex != NULL) {
+        c2d_destroy(slab->cortex);
+    }
+
+    // Free halo buffers.
+    free(slab->send_buffer);
+    free(slab->recv_buffer);
+
+    // Free slab.
+    free(slab);
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t s2d_load(
+    bhm_slab2d_t* slab,
+    bhm_cortex2d_t* cortex
+) {
+    if (cortex->width != slab->width || cortex->height != slab->height || cortex->nh_radius != slab->nh_radius) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    // Halos are only exchanged between adjacent slabs, so the first and last ones can't wrap around to each other.
+    if (cortex->boundary_mode == BHM_BOUNDARY_MODE_TORUS) {
+        return BHM_ERROR_NOT_SUPPORTED;
+    }
+
+    // Take all properties but size and storage from the cortex. Slabs keep their rows in row major layout, so that halos are contiguous.
+    bhm_cortex2d_t* local = slab->cortex;
+    bhm_cortex2d_t own = *local;
+    *local = *cortex;
+    local->width = own.width;
+    local->height = own.height;
+    local->storage_mode = own.storage_mode;
+    local->layout = own.layout;
+    local->tile_width = own.tile_width;
+    local->tile_height = own.tile_height;
+    local->numa_policy = own.numa_policy;
+    local->page_mode = own.page_mode;
+    local->page_size = own.page_size;
+    local->fired = own.fired;
+    local->events = own.events;
+    local->neurons = own.neurons;
+    local->soa = own.soa;
+
+    bhm_error_code_t error = c2d_set_storage_mode(local, cortex->storage_mode);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    // Copy owned rows along with halos.
+    c2d_copy_rows(local, 0, cortex, slab->y0 - slab->halo_top, local->height);
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t s2d_store(
+    bhm_slab2d_t* slab,
+    bhm_cortex2d_t* cortex
+) {
+    if (cortex->width != slab->width || cortex->height != slab->height || cortex->nh_radius != slab->nh_radius) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    c2d_copy_rows(cortex, slab->y0, slab->cortex, slab->halo_top, slab->y1 - slab->y0);
+
+    cortex->ticks_count = slab->cortex->ticks_count;
+    cortex->evols_count = slab->cortex->evols_count;
+
+    return BHM_ERROR_NONE;
+}
+
+/// @brief Packs the values and pulses of [nh_radius] rows of the slab's cortex starting at row [y] into the slab's send buffer.
+static void s2d_pack_rows(bhm_slab2d_t* slab, bhm_cortex_size_t y) {
+    const bhm_cortex2d_t* cortex = slab->cortex;
+    bhm_cortex_size_t count = slab->nh_radius * cortex->width;
+    bhm_cortex_size_t first = IDX2D(0, y, cortex->width);
+    bhm_neuron_value_t* values = (bhm_neuron_value_t*) slab->send_buffer;
+    bhm_ticks_count_t* pulses = (bhm_ticks_count_t*) (slab->send_buffer + count * sizeof(bhm_neuron_value_t));
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        memcpy(values, &(cortex->soa.value[first]), count * sizeof(bhm_neuron_value_t));
+        memcpy(pulses, &(cortex->soa.pulse[first]), count * sizeof(bhm_ticks_count_t));
+    } else {
+        for (bhm_cortex_size_t i = 0; i < count; i++) {
+            values[i] = cortex->neurons[first + i].value;
+            pulses[i] = cortex->neurons[first + i].pulse;
+        }
+    }
+}
+
+/// @brief Unpacks the values and pulses held by the slab's receive buffer into [nh_radius] rows of the slab's cortex starting at row [y].
+static void s2d_unpack_rows(bhm_slab2d_t* slab, bhm_cortex_size_t y) {
+    bhm_cortex2d_t* cortex = slab->cortex;
+    bhm_cortex_size_t count = slab->nh_radius * cortex->width;
+    bhm_cortex_size_t first = IDX2D(0, y, cortex->width);
+    const bhm_neuron_value_t* values = (const bhm_neuron_value_t*) slab->recv_buffer;
+    const bhm_ticks_count_t* pulses = (const bhm_ticks_count_t*) (slab->recv_buffer + count * sizeof(bhm_neuron_value_t));
+
+    if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+        memcpy(&(cortex->soa.value[first]), values, count * sizeof(bhm_neuron_value_t));
+        memcpy(&(cortex->soa.pulse[first]), pulses, count * sizeof(bhm_ticks_count_t));
+    } else {
+        for (bhm_cortex_size_t i = 0; i < count; i++) {
+            cortex->neurons[first + i].value = values[i];
+            cortex->neurons[first + i].pulse = pulses[i];
+        }
+    }
+}
+
+/// @brief Swaps halos with the slab below the given one, as its upper neighbor.
+static bhm_error_code_t s2d_exchange_below(bhm_slab2d_t* slab) {
+    bhm_transport_t* transport = slab->transport;
+    size_t halo_size = (size_t) slab->nh_radius * slab->width * (sizeof(bhm_neuron_value_t) + sizeof(bhm_ticks_count_t));
+    bhm_cortex_size_t owned_end = slab->halo_top + (slab->y1 - slab->y0);
+
+    // The bottom owned rows are the lower slab's top halo.
+    s2d_pack_rows(slab, owned_end - slab->nh_radius);
+    bhm_error_code_t error = transport->send(transport, transport->rank + 1, slab->send_buffer, halo_size);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+
+    error = transport->recv(transport, transport->rank + 1, slab->recv_buffer, halo_size);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+    s2d_unpack_rows(slab, owned_end);
+
+    return BHM_ERROR_NONE;
+}
+
+/// @brief Swaps halos with the slab above the given one, as its lower neighbor.
+static bhm_error_code_t s2d_exchange_above(bhm_slab2d_t* slab) {
+    bhm_transport_t* transport = slab->transport;
+    size_t halo_size = (size_t) slab->nh_radius * slab->width * (sizeof(bhm_neuron_value_t) + sizeof(bhm_ticks_count_t));
+
+    // Receive first, since the upper slab sends first.
+    bhm_error_code_t error = transport->recv(transport, transport->rank - 1, slab->recv_buffer, halo_size);
+    if (error != BHM_ERROR_NONE) {
+        return error;
+    }
+    s2d_unpack_rows(slab, 0);
+
+    // The top owned rows are the upper slab's bottom halo.
+    s2d_pack_rows(slab, slab->halo_top);
+    return transport->send(transport, transport->rank - 1, slab->send_buffer, halo_size);
+}
+
+bhm_error_code_t s2d_exchange_halos(
+    bhm_slab2d_t* slab
+) {
+    uint32_t rank = slab->transport->rank;
+    uint32_t ranks_count = slab->transport->ranks_count;
+
+    if (slab->nh_radius > 0) {
+        // Slabs pair up with even ones on top first, then with odd ones on top, so that every send finds its receiver
+        // and no transport needs to buffer a whole halo.
+        for (uint32_t phase = 0; phase < 2; phase++) {
+            bhm_error_code_t error = BHM_ERROR_NONE;
+            if (rank % 2 == phase) {
+                if (rank + 1 < ranks_count) {
+                    error = s2d_exchange_below(slab);
+                }
+            } else if (rank > 0) {
+                error = s2d_exchange_above(slab);
+            }
+            if (error != BHM_ERROR_NONE) {
+                return error;
+            }
+        }
+    }
+
+    // Halos changed outside of ticks.
+    slab->cortex->fired.valid = BHM_FALSE;
+    events_invalidate(&(slab->cortex->events));
+
+    return BHM_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
@@ -0,0 +1,184 @@
+/*
+*****************************************************************
+partition.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __CORTEX_PARTITION__
+#define __CORTEX_PARTITION__
+
+#include "cortex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Amount of attempts made by a process to reach the others while setting up a transport, BHM_TRANSPORT_RETRY_NS apart.
+#define BHM_TRANSPORT_CONNECT_RETRIES 0x2710U
+#define BHM_TRANSPORT_RETRY_NS 0x000F4240U
+
+// Default size of each shared memory channel: bigger messages are split into as many chunks as needed.
+#define BHM_DEFAULT_SHM_CAPACITY 0x00040000U
+
+/// @brief Point-to-point messaging between the processes sharing a partitioned cortex, each identified by its rank.
+/// Custom transports can be plugged in by filling in a transport with their own functions and state.
+typedef struct bhm_transport {
+    // Rank of the current process.
+    uint32_t rank;
+    // Amount of processes reachable through the transport, ranked 0 to ranks_count - 1.
+    uint32_t ranks_count;
+
+    // Sends [size] bytes from [data] to process [to_rank]. May block until [to_rank] starts receiving them.
+    bhm_error_code_t (*send)(struct bhm_transport* transport, uint32_t to_rank, const void* data, size_t size);
+    // Receives [size] bytes sent by process [from_rank] into [data], blocking until they're all there.
+    bhm_error_code_t (*recv)(struct bhm_transport* transport, uint32_t from_rank, void* data, size_t size);
+    // Releases the resources held by [state], may be NULL.
+    void (*close)(struct bhm_transport* transport);
+
+    // Implementation specific state.
+    void* state;
+} bhm_transport_t;
+
+/// @brief Horizontal slab of a 2D cortex partitioned among processes: each process owns a band of consecutive rows.
+/// Neurons are kept in a regular cortex holding the owned rows plus halos of [nh_radius] rows above and below them,
+/// which mirror the neighboring slabs' edges and are refreshed before each tick.
+/// Owned rows evolve exactly like the same rows of the whole cortex, except in counter rand mode, whose streams are keyed by each neuron's
+/// position in the slab's cortex rather than in the whole one.
+typedef struct {
+    // Size of the whole partitioned cortex.
+    bhm_cortex_size_t width;
+    bhm_cortex_size_t height;
+    bhm_nh_radius_t nh_radius;
+
+    // Rows of the whole cortex owned by the slab, [y0, y1).
+    bhm_cortex_size_t y0;
+    bhm_cortex_size_t y1;
+
+    // Amount of halo rows held above and below the owned ones: [nh_radius], unless the slab lies at the top or bottom of the cortex.
+    bhm_cortex_size_t halo_top;
+    bhm_cortex_size_t halo_bottom;
+
+    // Transport halos are exchanged through, the slab owning the rank-th band of rows.
+    bhm_transport_t* transport;
+
+    // Owned rows, starting at row [halo_top], along with their halos.
+    bhm_cortex2d_t* cortex;
+
+    // Staging storage for outgoing and incoming halos.
+    bhm_byte* send_buffer;
+    bhm_byte* recv_buffer;
+} bhm_slab2d_t;
+
+
+// ##########################################
+// Transport functions
+// ##########################################
+
+/// @brief Creates a transport backed by a shared memory segment, for processes on the same machine.
+/// All processes must use the same name and amount of ranks. The process ranked 0 creates the segment, while the others wait for it.
+/// @param transport The transport to create.
+/// @param name The name of the shared memory segment, in the form "/name". Must not be in use by other transports.
+/// @param rank The rank of the current process.
+/// @param ranks_count The amount of processes sharing the transport.
+/// @param capacity The size of the channel from each process to each other process, in bytes.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_EXTERNAL_CAUSES] if the segment could not be set up,
+/// [BHM_ERROR_NOT_SUPPORTED] if shared memory is not available on the current platform.
+bhm_error_code_t transport_shm_create(
+    bhm_transport_t** transport,
+    const char* name,
+    uint32_t rank,
+    uint32_t ranks_count,
+    size_t capacity
+);
+
+/// @brief Creates a transport backed by Unix domain sockets, for processes on the same machine.
+/// Each process listens on "[path].[rank]" until all others are connected to it.
+/// @param transport The transport to create.
+/// @param path The path the processes' socket paths are derived from.
+/// @param rank The rank of the current process.
+/// @param ranks_count The amount of processes sharing the transport.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_EXTERNAL_CAUSES] if processes could not connect,
+/// [BHM_ERROR_NOT_SUPPORTED] if Unix domain sockets are not available on the current platform.
+bhm_error_code_t transport_socket_create(
+    bhm_transport_t** transport,
+    const char* path,
+    uint32_t rank,
+    uint32_t ranks_count
+);
+
+/// @brief Closes the provided transport and frees memory for it.
+/// @param transport The transport to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t transport_destroy(
+    bhm_transport_t* transport
+);
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Slab functions
+// ##########################################
+
+/// @brief Allocates and initializes the slab of a partitioned cortex owned by the current process.
+/// Rows are split evenly among the transport's ranks, in rank order from the top.
+/// @param slab The slab to create.
+/// @param width The width of the whole cortex.
+/// @param height The height of the whole cortex.
+/// @param nh_radius The neighborhood radius for each individual cortex neuron.
+/// @param transport The transport to exchange halos through.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if any slab would own fewer rows than [nh_radius].
+bhm_error_code_t s2d_create(
+    bhm_slab2d_t** slab,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_nh_radius_t nh_radius,
+    bhm_transport_t* transport
+);
+
+/// @brief Destroys the given slab and frees memory for it and its neurons. The slab's transport is left untouched.
+/// @param slab The slab to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t s2d_destroy(
+    bhm_slab2d_t* slab
+);
+
+/// @brief Copies the properties, storage mode and the rows held by the slab of a whole cortex into the slab.
+/// Slabs always store their rows in row major layout, whatever the whole cortex' layout.
+/// @param slab The slab to copy the cortex into.
+/// @param cortex The whole cortex to copy, shaped like the partitioned cortex.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if the cortex is shaped differently,
+/// [BHM_ERROR_NOT_SUPPORTED] if the cortex is in torus boundary mode.
+bhm_error_code_t s2d_load(
+    bhm_slab2d_t* slab,
+    bhm_cortex2d_t* cortex
+);
+
+/// @brief Copies the rows owned by the slab, along with its ticks and evolutions counts, into a whole cortex.
+/// @param slab The slab to copy.
+/// @param cortex The whole cortex to copy the slab into, shaped like the partitioned cortex.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if the cortex is shaped differently.
+bhm_error_code_t s2d_store(
+    bhm_slab2d_t* slab,
+    bhm_cortex2d_t* cortex
+);
+
+/// @brief Refreshes the slab's halos with the values and pulses of the neighboring slabs' edge rows, sending its own edge rows to them.
+/// Must be called by all processes sharing the transport at once.
+/// @param slab The slab whose halos to refresh.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t s2d_exchange_halos(
+    bhm_slab2d_t* slab
+);
+
+// ##########################################
+// ##########################################
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
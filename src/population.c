@@ -76,9 +76,9 @@ bhm_error_code_t p2d_populate(
         bhm_error_code_t error = c2d_init(&(population->cortices[i]), width, height, nh_radius);
         if (error != BHM_ERROR_NONE) {
             // There was an error initializing a cortex, so abort population setup, clean what's been initialized up to now and return the error.
-            for (bhm_population_size_t j = 0; j < i - 1; j++) {
-                // Destroy the jth cortex.
-                c2d_destroy(&(population->cortices[j]));
+            for (bhm_population_size_t j = 0; j < i; j++) {
+                // Deinit the jth cortex, which is part of the population's cortices array.
+                c2d_deinit(&(population->cortices[j]));
             }
             return error;
         }
@@ -100,9 +100,9 @@ bhm_error_code_t p2d_rand_populate(
         bhm_error_code_t error = c2d_rand_init(&(population->cortices[i]), width, height, nh_radius);
         if (error != BHM_ERROR_NONE) {
             // There was an error initializing a cortex, so abort population setup, clean what's been initialized up to now and return the error.
-            for (bhm_population_size_t j = 0; j < i - 1; j++) {
-                // Destroy the jth cortex.
-                c2d_destroy(&(population->cortices[j]));
+            for (bhm_population_size_t j = 0; j < i; j++) {
+                // Deinit the jth cortex, which is part of the population's cortices array.
+                c2d_deinit(&(population->cortices[j]));
             }
             return error;
         }
@@ -113,7 +113,7 @@ bhm_error_code_t p2d_rand_populate(
 
 bhm_error_code_t p2d_destroy_cortices(bhm_population2d_t* population) {
     for (bhm_population_size_t i = 0; i < population->size; i++) {
-        free(population->cortices[i].neurons);
+        c2d_deinit(&(population->cortices[i]));
     }
 
     free(population->cortices);
@@ -297,26 +297,40 @@ bhm_error_code_t p2d_breed(bhm_population2d_t* population, bhm_cortex2d_t** chil
     // Pick neurons' max syn count from a random parent.
     population->rand_state = xorshf32(population->rand_state);
     winner_parent_index = population->rand_state % population->parents_count;
-    bhm_cortex2d_t msc_parent = parents[winner_parent_index];
+    bhm_cortex2d_t* msc_parent = &(parents[winner_parent_index]);
 
     // Pick neurons' inhexc ratio from a random parent.
     population->rand_state = xorshf32(population->rand_state);
     winner_parent_index = population->rand_state % population->parents_count;
-    bhm_cortex2d_t inhexc_parent = parents[winner_parent_index];
-
-    // Pick neuron values from parents.
-    for (bhm_cortex_size_t y = 0; y < (*child)->height; y++) {
-        for (bhm_cortex_size_t x = 0; x < (*child)->width; x++) {
-            (*child)->neurons[IDX2D(x, y, (*child)->width)].max_syn_count = msc_parent.neurons[IDX2D(x, y, (*child)->width)].max_syn_count;
-            (*child)->neurons[IDX2D(x, y, (*child)->width)].inhexc_ratio = inhexc_parent.neurons[IDX2D(x, y, (*child)->width)].inhexc_ratio;
+    bhm_cortex2d_t* inhexc_parent = &(parents[winner_parent_index]);
+
+    // Pick neuron values from parents, whatever storage mode they're in.
+    for (bhm_cortex_size_t y = 0; y < (*child)->height && error == BHM_ERROR_NONE; y++) {
+        for (bhm_cortex_size_t x = 0; x < (*child)->width && error == BHM_ERROR_NONE; x++) {
+            bhm_neuron_t child_neuron;
+            bhm_neuron_t msc_neuron;
+            bhm_neuron_t inhexc_neuron;
+            error = c2d_get_neuron(*child, x, y, &child_neuron);
+            if (error == BHM_ERROR_NONE) error = c2d_get_neuron(msc_parent, x, y, &msc_neuron);
+            if (error == BHM_ERROR_NONE) error = c2d_get_neuron(inhexc_parent, x, y, &inhexc_neuron);
+            if (error == BHM_ERROR_NONE) {
+                child_neuron.max_syn_count = msc_neuron.max_syn_count;
+                child_neuron.inhexc_ratio = inhexc_neuron.inhexc_ratio;
+                error = c2d_set_neuron(*child, x, y, &child_neuron);
+            }
         }
     }
 
+    // Parents not covering the child's shape leave it incomplete.
+    if (error != BHM_ERROR_NONE) {
+        c2d_destroy(*child);
+    }
+
     // Free up temp arrays.
     free(parents);
     free(parents_indexes);
 
-    return BHM_ERROR_NONE;
+    return error;
 }
 
 bhm_error_code_t p2d_crossover(bhm_population2d_t* population, bhm_bool_t mutate) {
@@ -347,8 +361,9 @@ bhm_error_code_t p2d_crossover(bhm_population2d_t* population, bhm_bool_t mutate
             }
         }
 
-        // Store the produced child.
+        // Store the produced child, whose neurons now belong to the offspring.
         offspring[i] = *child;
+        free(child);
     }
 
     // Replace the old generation with the new one.
@@ -371,4 +386,155 @@ bhm_error_code_t p2d_mutate(bhm_population2d_t* population) {
 }
 
 // ##########################################
-// ##########################################
\ No newline at end of file
+// ##########################################
+
+// ##########################################
+// Ensemble functions
+// ##########################################
+
+bhm_error_code_t e2d_create(bhm_ensemble2d_t** ensemble, bhm_cortex2d_t* cortices, bhm_population_size_t count) {
+    if (count <= 0) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    // Allocate the ensemble.
+    (*ensemble) = (bhm_ensemble2d_t*) malloc(sizeof(bhm_ensemble2d_t));
+    if ((*ensemble) == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    // The ensemble takes the shape of its first cortex.
+    (*ensemble)->width = cortices[0].width;
+    (*ensemble)->height = cortices[0].height;
+    (*ensemble)->nh_radius = cortices[0].nh_radius;
+    (*ensemble)->boundary_mode = cortices[0].boundary_mode;
+    (*ensemble)->lanes_count = count;
+    (*ensemble)->page_mode = cortices[0].page_mode;
+    (*ensemble)->page_size = 0;
+    (*ensemble)->soa = (bhm_neurons_soa_t) {0};
+    (*ensemble)->next_soa = (bhm_neurons_soa_t) {0};
+
+    // Allocate lanes and their properties for lockstep ticks.
+    (*ensemble)->lanes = (bhm_cortex2d_t*) calloc(count, sizeof(bhm_cortex2d_t));
+    (*ensemble)->lanes_params = (uint32_t*) malloc(6 * count * sizeof(uint32_t));
+    if ((*ensemble)->lanes == NULL || (*ensemble)->lanes_params == NULL) {
+        e2d_destroy(*ensemble);
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+
+    // Allocate neurons for both buffers, which then share their static state.
+    bhm_cortex_size_t neurons_count = (*ensemble)->width * (*ensemble)->height * count;
+    bhm_error_code_t error = soa_alloc(&((*ensemble)->soa), neurons_count, (*ensemble)->page_mode, &((*ensemble)->page_size));
+    if (error == BHM_ERROR_NONE) {
+        error = soa_alloc(&((*ensemble)->next_soa), neurons_count, (*ensemble)->page_mode, NULL);
+    }
+    if (error != BHM_ERROR_NONE) {
+        e2d_destroy(*ensemble);
+        return error;
+    }
+    soa_share_static(&((*ensemble)->next_soa), &((*ensemble)->soa));
+
+    error = e2d_gather(*ensemble, cortices);
+    if (error != BHM_ERROR_NONE) {
+        e2d_destroy(*ensemble);
+        return error;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t e2d_destroy(bhm_ensemble2d_t* ensemble) {
+    // Free neurons.
+    soa_free(&(ensemble->soa));
+    soa_free(&(ensemble->next_soa));
+
+    // Free lanes.
+    free(ensemble->lanes);
+    free(ensemble->lanes_params);
+
+    // Free ensemble.
+    free(ensemble);
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t e2d_gather(bhm_ensemble2d_t* ensemble, bhm_cortex2d_t* cortices) {
+    const bhm_population_size_t lanes_count = ensemble->lanes_count;
+
+    // Make sure all cortices fit the ensemble.
+    for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+        if (cortices[l].width != ensemble->width || cortices[l].height != ensemble->height || cortices[l].nh_radius != ensemble->nh_radius ||
+            cortices[l].boundary_mode != ensemble->boundary_mode) {
+            return BHM_ERROR_SIZE_WRONG;
+        }
+    }
+
+    // Copy properties, leaving lanes with no neuron storage of their own.
+    for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+        ensemble->lanes[l] = cortices[l];
+        ensemble->lanes[l].neurons = NULL;
+        ensemble->lanes[l].soa = (bhm_neurons_soa_t) {0};
+        ensemble->lanes[l].fired = (bhm_fired_bitmap_t) {0};
+        ensemble->lanes[l].events = (bhm_tile_events_t) {0};
+    }
+
+    // Interleave neurons, so that all lanes of each neuron end up next to each other.
+    #pragma omp parallel for schedule(static)
+    for (bhm_cortex_size_t y = 0; y < ensemble->height; y++) {
+        for (bhm_cortex_size_t x = 0; x < ensemble->width; x++) {
+            bhm_cortex_size_t index = IDX2D(x, y, ensemble->width) * lanes_count;
+            for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+                bhm_neuron_t neuron;
+                c2d_get_neuron(&(cortices[l]), x, y, &neuron);
+                soa_store_neuron(&(ensemble->soa), index + l, &neuron);
+            }
+        }
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t e2d_scatter(const bhm_ensemble2d_t* ensemble, bhm_cortex2d_t* cortices) {
+    const bhm_population_size_t lanes_count = ensemble->lanes_count;
+
+    // Make sure all cortices fit the ensemble.
+    for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+        if (cortices[l].width != ensemble->width || cortices[l].height != ensemble->height || cortices[l].nh_radius != ensemble->nh_radius ||
+            cortices[l].boundary_mode != ensemble->boundary_mode) {
+            return BHM_ERROR_SIZE_WRONG;
+        }
+    }
+
+    // Deinterleave neurons, writing them straight to each cortex' storage.
+    #pragma omp parallel for schedule(static)
+    for (bhm_cortex_size_t y = 0; y < ensemble->height; y++) {
+        for (bhm_cortex_size_t x = 0; x < ensemble->width; x++) {
+            bhm_cortex_size_t index = IDX2D(x, y, ensemble->width) * lanes_count;
+            for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+                bhm_neuron_t neuron;
+                soa_load_neuron(&(ensemble->soa), index + l, &neuron);
+
+                // Lanes are always interleaved row by row, while each cortex keeps its own layout.
+                bhm_cortex_size_t neuron_index = c2d_neuron_index(&(cortices[l]), x, y);
+                if (cortices[l].storage_mode == BHM_STORAGE_MODE_SOA) {
+                    soa_store_neuron(&(cortices[l].soa), neuron_index, &neuron);
+                } else {
+                    cortices[l].neurons[neuron_index] = neuron;
+                }
+            }
+        }
+    }
+
+    for (bhm_population_size_t l = 0; l < lanes_count; l++) {
+        cortices[l].ticks_count = ensemble->lanes[l].ticks_count;
+        cortices[l].evols_count = ensemble->lanes[l].evols_count;
+
+        cortices[l].fired.valid = BHM_FALSE;
+        events_invalidate(&(cortices[l].events));
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+// ##########################################
+// ##########################################
@@ -20,6 +20,9 @@ extern "C" {
 #define DEFAULT_PARENTS_COUNT 0x0002U
 #define DEFAULT_MUT_CHANCE 0x000002A0U
 
+// Maximum amount of lanes the vectorized ensemble tick updates at once for each neuron, which bounds the size of its working set.
+#define BHM_ENSEMBLE_BLOCK_LANES 0x40U
+
 typedef uint16_t bhm_cortex_fitness_t;
 typedef uint16_t bhm_population_size_t;
 
@@ -58,6 +61,34 @@ typedef struct {
     bhm_population_size_t* selection_pool;
 } bhm_population2d_t;
 
+/// @brief Same-shape 2D cortices interleaved neuron by neuron, so that they can be ticked in lockstep with one vector lane per cortex.
+typedef struct {
+    // Shape shared by all interleaved cortices.
+    bhm_cortex_size_t width;
+    bhm_cortex_size_t height;
+    bhm_nh_radius_t nh_radius;
+    bhm_boundary_mode_t boundary_mode;
+
+    // Amount of interleaved cortices.
+    bhm_population_size_t lanes_count;
+
+    // Properties of each interleaved cortex, with no neuron storage of their own.
+    // Each lane's ticks and evolutions counts follow the ensemble's ticks.
+    bhm_cortex2d_t* lanes;
+
+    // Room for the properties of all lanes widened to 32 bits, six words per lane, which lockstep ticks lay out as arrays.
+    uint32_t* lanes_params;
+
+    // Which pages neuron storage is backed by, and the size of the pages it actually got.
+    bhm_page_mode_t page_mode;
+    size_t page_size;
+
+    // Neurons of all interleaved cortices: neuron i of lane l is stored at index i * lanes_count + l.
+    // Ticks read from [soa] and write to [next_soa] before swapping them. Both share their static state, which only evolution ticks change.
+    bhm_neurons_soa_t soa;
+    bhm_neurons_soa_t next_soa;
+} bhm_ensemble2d_t;
+
 
 // ##########################################
 // Utility functions.
@@ -190,6 +221,38 @@ bhm_error_code_t p2d_mutate(bhm_population2d_t* population);
 // ##########################################
 
 
+// ##########################################
+// Ensemble functions
+// ##########################################
+
+/// @brief Allocates an ensemble interleaving the provided cortices and gathers them into it.
+/// @param ensemble The ensemble to create.
+/// @param cortices The cortices to interleave, which must all share the same width, height, neighborhood radius and boundary mode.
+/// @param count The amount of cortices in [cortices].
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if [count] is 0 or cortices have different shapes.
+bhm_error_code_t e2d_create(bhm_ensemble2d_t** ensemble, bhm_cortex2d_t* cortices, bhm_population_size_t count);
+
+/// @brief Destroys the given ensemble and frees memory for it, its lanes and its neurons.
+/// @param ensemble The ensemble to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t e2d_destroy(bhm_ensemble2d_t* ensemble);
+
+/// @brief Copies the properties and neurons of the provided cortices into the lanes of the ensemble, the i-th cortex going to the i-th lane.
+/// @param ensemble The ensemble to gather cortices into.
+/// @param cortices The cortices to gather, as many as the ensemble's lanes and all shaped like the ensemble.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if any cortex is shaped differently from the ensemble.
+bhm_error_code_t e2d_gather(bhm_ensemble2d_t* ensemble, bhm_cortex2d_t* cortices);
+
+/// @brief Copies the neurons and ticks and evolutions counts of each lane of the ensemble back to the provided cortices, the i-th lane going to the i-th cortex.
+/// @param ensemble The ensemble to scatter.
+/// @param cortices The cortices to scatter lanes to, as many as the ensemble's lanes and all shaped like the ensemble.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if any cortex is shaped differently from the ensemble.
+bhm_error_code_t e2d_scatter(const bhm_ensemble2d_t* ensemble, bhm_cortex2d_t* cortices);
+
+// ##########################################
+// ##########################################
+
+
 #ifdef __cplusplus
 }
 #endif
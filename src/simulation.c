@@ -0,0 +1,296 @@
+#include "simulation.h"
+
+/// @brief Makes the two cortices of the simulation share their static state in SOA storage mode, so that it's only held once.
+/// Both cortices are always edited alike, so their static states are the same when this is called.
+static bhm_error_code_t sim2d_share_static(
+    bhm_sim2d_t* sim
+) {
+    if (sim->prev_cortex->storage_mode != BHM_STORAGE_MODE_SOA) {
+        return BHM_ERROR_NONE;
+    }
+
+    return c2d_share_static(sim->next_cortex, sim->prev_cortex);
+}
+
+// ##########################################
+// Simulation functions
+// ##########################################
+
+bhm_error_code_t sim2d_create(
+    bhm_sim2d_t** sim,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_nh_radius_t nh_radius
+) {
+    // Allocate the simulation.
+    (*sim) = (bhm_sim2d_t*) malloc(sizeof(bhm_sim2d_t));
+    if ((*sim) == NULL) {
+        return BHM_ERROR_FAILED_ALLOC;
+    }
+    (*sim)->prev_cortex = NULL;
+    (*sim)->next_cortex = NULL;
+
+    // Cortices are initialized deterministically, so the two come out identical without copying one into the other.
+    bhm_error_code_t error = c2d_create(&((*sim)->prev_cortex), width, height, nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        sim2d_destroy(*sim);
+        return error;
+    }
+    error = c2d_create(&((*sim)->next_cortex), width, height, nh_radius);
+    if (error != BHM_ERROR_NONE) {
+        sim2d_destroy(*sim);
+        return error;
+    }
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t sim2d_destroy(
+    bhm_sim2d_t* sim
+) {
+    // Free cortices.
+    if (sim->prev_cortex != NULL) {
+        c2d_destroy(sim->prev_cortex);
+    }
+    if (sim->next_cortex != NULL) {
+        c2d_destroy(sim->next_cortex);
+    }
+
+    // Free simulation.
+    free(sim);
+
+    return BHM_ERROR_NONE;
+}
+
+bhm_error_code_t sim2d_load(
+    bhm_sim2d_t* sim,
+    bhm_cortex2d_t* cortex
+) {
+    if (cortex->width != sim->prev_cortex->width || cortex->height != sim->prev_cortex->height) {
+        return BHM_ERROR_SIZE_WRONG;
+    }
+
+    bhm_cortex2d_t* cortices[] = {sim->prev_cortex, sim->next_cortex};
+    for (int i = 0; i < 2; i++) {
+        // Neurons can only be copied between cortices sharing the same storage.
+        bhm_error_code_t error = c2d_set_storage_mode(cortices[i], cortex->storage_mode);
+        if (error != BHM_ERROR_NONE) {
+            return error;
+        }
+        error = c2d_set_layout(cortices[i], cortex->layout);
+        if (error != BHM_ERROR_NONE) {
+            return error;
+        }
+        error = c2d_copy(cortices[i], cortex);
+        if (error != BHM_ERROR_NONE) {
+            return error;
+        }
+    }
+
+    return sim2d_share_static(sim);
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions
+// ##########################################
+
+// Applies [SETTER] with the provided arguments to both cortices of [sim], stopping at the first error.
+#define SIM2D_SET_BOTH(SETTER, ...) \
+    bhm_error_code_t error = SETTER(sim->prev_cortex, __VA_ARGS__); \
+    if (error != BHM_ERROR_NONE) { \
+        return error; \
+    } \
+    return SETTER(sim->next_cortex, __VA_ARGS__);
+
+// Same as SIM2D_SET_BOTH, for setters moving neurons to new storage: static state is shared again afterwards.
+#define SIM2D_SET_BOTH_SHARED(SETTER, ...) \
+    bhm_error_code_t error = SETTER(sim->prev_cortex, __VA_ARGS__); \
+    if (error != BHM_ERROR_NONE) { \
+        return error; \
+    } \
+    error = SETTER(sim->next_cortex, __VA_ARGS__); \
+    if (error != BHM_ERROR_NONE) { \
+        return error; \
+    } \
+    return sim2d_share_static(sim);
+
+bhm_error_code_t sim2d_set_nhradius(
+    bhm_sim2d_t* sim,
+    bhm_nh_radius_t radius
+) {
+    SIM2D_SET_BOTH(c2d_set_nhradius, radius)
+}
+
+bhm_error_code_t sim2d_set_nhmask(
+    bhm_sim2d_t* sim,
+    bhm_nh_mask_t mask
+) {
+    SIM2D_SET_BOTH(c2d_set_nhmask, mask)
+}
+
+bhm_error_code_t sim2d_set_evol_step(
+    bhm_sim2d_t* sim,
+    bhm_evol_step_t evol_step
+) {
+    SIM2D_SET_BOTH(c2d_set_evol_step, evol_step)
+}
+
+bhm_error_code_t sim2d_set_pulse_window(
+    bhm_sim2d_t* sim,
+    bhm_ticks_count_t window
+) {
+    SIM2D_SET_BOTH(c2d_set_pulse_window, window)
+}
+
+bhm_error_code_t sim2d_set_sample_window(
+    bhm_sim2d_t* sim,
+    bhm_ticks_count_t sample_window
+) {
+    SIM2D_SET_BOTH(c2d_set_sample_window, sample_window)
+}
+
+bhm_error_code_t sim2d_set_fire_threshold(
+    bhm_sim2d_t* sim,
+    bhm_neuron_value_t threshold
+) {
+    SIM2D_SET_BOTH(c2d_set_fire_threshold, threshold)
+}
+
+bhm_error_code_t sim2d_set_syngen_chance(
+    bhm_sim2d_t* sim,
+    bhm_chance_t syngen_chance
+) {
+    SIM2D_SET_BOTH(c2d_set_syngen_chance, syngen_chance)
+}
+
+bhm_error_code_t sim2d_set_synstr_chance(
+    bhm_sim2d_t* sim,
+    bhm_chance_t synstr_chance
+) {
+    SIM2D_SET_BOTH(c2d_set_synstr_chance, synstr_chance)
+}
+
+bhm_error_code_t sim2d_set_max_syn_count(
+    bhm_sim2d_t* sim,
+    bhm_syn_count_t syn_count
+) {
+    SIM2D_SET_BOTH(c2d_set_max_syn_count, syn_count)
+}
+
+bhm_error_code_t sim2d_set_max_touch(
+    bhm_sim2d_t* sim,
+    float touch
+) {
+    SIM2D_SET_BOTH(c2d_set_max_touch, touch)
+}
+
+bhm_error_code_t sim2d_set_pulse_mapping(
+    bhm_sim2d_t* sim,
+    bhm_pulse_mapping_t pulse_mapping
+) {
+    SIM2D_SET_BOTH(c2d_set_pulse_mapping, pulse_mapping)
+}
+
+bhm_error_code_t sim2d_set_inhexc_range(
+    bhm_sim2d_t* sim,
+    bhm_chance_t inhexc_range
+) {
+    SIM2D_SET_BOTH(c2d_set_inhexc_range, inhexc_range)
+}
+
+bhm_error_code_t sim2d_set_inhexc_ratio(
+    bhm_sim2d_t* sim,
+    bhm_chance_t inhexc_ratio
+) {
+    SIM2D_SET_BOTH(c2d_set_inhexc_ratio, inhexc_ratio)
+}
+
+bhm_error_code_t sim2d_syn_disable(
+    bhm_sim2d_t* sim,
+    bhm_cortex_size_t x0,
+    bhm_cortex_size_t y0,
+    bhm_cortex_size_t x1,
+    bhm_cortex_size_t y1
+) {
+    SIM2D_SET_BOTH(c2d_syn_disable, x0, y0, x1, y1)
+}
+
+bhm_error_code_t sim2d_set_storage_mode(
+    bhm_sim2d_t* sim,
+    bhm_storage_mode_t storage_mode
+) {
+    SIM2D_SET_BOTH_SHARED(c2d_set_storage_mode, storage_mode)
+}
+
+bhm_error_code_t sim2d_set_tick_mode(
+    bhm_sim2d_t* sim,
+    bhm_tick_mode_t tick_mode
+) {
+    SIM2D_SET_BOTH(c2d_set_tick_mode, tick_mode)
+}
+
+bhm_error_code_t sim2d_set_rand_mode(
+    bhm_sim2d_t* sim,
+    bhm_rand_mode_t rand_mode
+) {
+    SIM2D_SET_BOTH(c2d_set_rand_mode, rand_mode)
+}
+
+bhm_error_code_t sim2d_set_integration_mode(
+    bhm_sim2d_t* sim,
+    bhm_integration_mode_t integration_mode
+) {
+    SIM2D_SET_BOTH(c2d_set_integration_mode, integration_mode)
+}
+
+bhm_error_code_t sim2d_set_boundary_mode(
+    bhm_sim2d_t* sim,
+    bhm_boundary_mode_t boundary_mode
+) {
+    SIM2D_SET_BOTH(c2d_set_boundary_mode, boundary_mode)
+}
+
+bhm_error_code_t sim2d_set_layout(
+    bhm_sim2d_t* sim,
+    bhm_layout_t layout
+) {
+    SIM2D_SET_BOTH_SHARED(c2d_set_layout, layout)
+}
+
+bhm_error_code_t sim2d_set_tile_size(
+    bhm_sim2d_t* sim,
+    bhm_cortex_size_t tile_width,
+    bhm_cortex_size_t tile_height
+) {
+    SIM2D_SET_BOTH(c2d_set_tile_size, tile_width, tile_height)
+}
+
+bhm_error_code_t sim2d_set_numa_policy(
+    bhm_sim2d_t* sim,
+    bhm_numa_policy_t numa_policy
+) {
+    SIM2D_SET_BOTH_SHARED(c2d_set_numa_policy, numa_policy)
+}
+
+bhm_error_code_t sim2d_set_page_mode(
+    bhm_sim2d_t* sim,
+    bhm_page_mode_t page_mode
+) {
+    SIM2D_SET_BOTH_SHARED(c2d_set_page_mode, page_mode)
+}
+
+bhm_error_code_t sim2d_set_neuron(
+    bhm_sim2d_t* sim,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_neuron_t* neuron
+) {
+    SIM2D_SET_BOTH(c2d_set_neuron, x, y, neuron)
+}
+
+// ##########################################
+// ##########################################
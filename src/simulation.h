@@ -0,0 +1,217 @@
+/*
+*****************************************************************
+simulation.h
+
+Copyright (C) 2024 Luka Micheletti
+*****************************************************************
+*/
+
+#ifndef __CORTEX_SIMULATION__
+#define __CORTEX_SIMULATION__
+
+#include "cortex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Double buffered 2D cortex: owns the two cortices ticks alternate between, and swaps them after each step,
+/// so that the latest state is always found in [prev_cortex].
+/// Setters are applied to both cortices, which saves copying one into the other after each change.
+/// In SOA storage mode the two cortices share their static state (see c2d_share_static), so synapses are only held once.
+typedef struct {
+    // Cortex holding the latest state, which the next step ticks from.
+    bhm_cortex2d_t* prev_cortex;
+    // Cortex the next step ticks into, holding the state before the latest step.
+    bhm_cortex2d_t* next_cortex;
+} bhm_sim2d_t;
+
+
+// ##########################################
+// Simulation functions
+// ##########################################
+
+/// @brief Allocates and initializes a simulation, whose two cortices are initialized the same way as by c2d_create.
+/// @param sim The simulation to create.
+/// @param width The width of the cortex.
+/// @param height The height of the cortex.
+/// @param nh_radius The neighborhood radius for each individual cortex neuron.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t sim2d_create(
+    bhm_sim2d_t** sim,
+    bhm_cortex_size_t width,
+    bhm_cortex_size_t height,
+    bhm_nh_radius_t nh_radius
+);
+
+/// @brief Destroys the given simulation and frees memory for it and both its cortices.
+/// @param sim The simulation to destroy.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none.
+bhm_error_code_t sim2d_destroy(
+    bhm_sim2d_t* sim
+);
+
+/// @brief Copies the properties, storage mode, layout and neurons of a cortex into both cortices of the simulation,
+/// which share their static state from then on in SOA storage mode.
+/// @param sim The simulation to copy the cortex into.
+/// @param cortex The cortex to copy, shaped like the simulation's cortices.
+/// @return The code for the occurred error, [BHM_ERROR_NONE] if none, [BHM_ERROR_SIZE_WRONG] if the cortex is shaped differently.
+bhm_error_code_t sim2d_load(
+    bhm_sim2d_t* sim,
+    bhm_cortex2d_t* cortex
+);
+
+/// @brief Returns the cortex holding the latest state of the simulation, which inputs are fed to and outputs read from.
+/// The returned cortex changes after each step.
+/// @param sim The simulation to get the cortex of.
+/// @return The cortex holding the latest state.
+static inline bhm_cortex2d_t* sim2d_cortex(
+    const bhm_sim2d_t* sim
+) {
+    return sim->prev_cortex;
+}
+
+// ##########################################
+// ##########################################
+
+
+// ##########################################
+// Setter functions
+// ##########################################
+// Each setter applies the homonymous cortex setter to both cortices of the simulation, see cortex.h.
+// The second cortex is only edited if the first one accepts the change.
+
+bhm_error_code_t sim2d_set_nhradius(
+    bhm_sim2d_t* sim,
+    bhm_nh_radius_t radius
+);
+
+bhm_error_code_t sim2d_set_nhmask(
+    bhm_sim2d_t* sim,
+    bhm_nh_mask_t mask
+);
+
+bhm_error_code_t sim2d_set_evol_step(
+    bhm_sim2d_t* sim,
+    bhm_evol_step_t evol_step
+);
+
+bhm_error_code_t sim2d_set_pulse_window(
+    bhm_sim2d_t* sim,
+    bhm_ticks_count_t window
+);
+
+bhm_error_code_t sim2d_set_sample_window(
+    bhm_sim2d_t* sim,
+    bhm_ticks_count_t sample_window
+);
+
+bhm_error_code_t sim2d_set_fire_threshold(
+    bhm_sim2d_t* sim,
+    bhm_neuron_value_t threshold
+);
+
+bhm_error_code_t sim2d_set_syngen_chance(
+    bhm_sim2d_t* sim,
+    bhm_chance_t syngen_chance
+);
+
+bhm_error_code_t sim2d_set_synstr_chance(
+    bhm_sim2d_t* sim,
+    bhm_chance_t synstr_chance
+);
+
+bhm_error_code_t sim2d_set_max_syn_count(
+    bhm_sim2d_t* sim,
+    bhm_syn_count_t syn_count
+);
+
+bhm_error_code_t sim2d_set_max_touch(
+    bhm_sim2d_t* sim,
+    float touch
+);
+
+bhm_error_code_t sim2d_set_pulse_mapping(
+    bhm_sim2d_t* sim,
+    bhm_pulse_mapping_t pulse_mapping
+);
+
+bhm_error_code_t sim2d_set_inhexc_range(
+    bhm_sim2d_t* sim,
+    bhm_chance_t inhexc_range
+);
+
+bhm_error_code_t sim2d_set_inhexc_ratio(
+    bhm_sim2d_t* sim,
+    bhm_chance_t inhexc_ratio
+);
+
+bhm_error_code_t sim2d_syn_disable(
+    bhm_sim2d_t* sim,
+    bhm_cortex_size_t x0,
+    bhm_cortex_size_t y0,
+    bhm_cortex_size_t x1,
+    bhm_cortex_size_t y1
+);
+
+bhm_error_code_t sim2d_set_storage_mode(
+    bhm_sim2d_t* sim,
+    bhm_storage_mode_t storage_mode
+);
+
+bhm_error_code_t sim2d_set_tick_mode(
+    bhm_sim2d_t* sim,
+    bhm_tick_mode_t tick_mode
+);
+
+bhm_error_code_t sim2d_set_rand_mode(
+    bhm_sim2d_t* sim,
+    bhm_rand_mode_t rand_mode
+);
+
+bhm_error_code_t sim2d_set_integration_mode(
+    bhm_sim2d_t* sim,
+    bhm_integration_mode_t integration_mode
+);
+
+bhm_error_code_t sim2d_set_boundary_mode(
+    bhm_sim2d_t* sim,
+    bhm_boundary_mode_t boundary_mode
+);
+
+bhm_error_code_t sim2d_set_layout(
+    bhm_sim2d_t* sim,
+    bhm_layout_t layout
+);
+
+bhm_error_code_t sim2d_set_tile_size(
+    bhm_sim2d_t* sim,
+    bhm_cortex_size_t tile_width,
+    bhm_cortex_size_t tile_height
+);
+
+bhm_error_code_t sim2d_set_numa_policy(
+    bhm_sim2d_t* sim,
+    bhm_numa_policy_t numa_policy
+);
+
+bhm_error_code_t sim2d_set_page_mode(
+    bhm_sim2d_t* sim,
+    bhm_page_mode_t page_mode
+);
+
+bhm_error_code_t sim2d_set_neuron(
+    bhm_sim2d_t* sim,
+    bhm_cortex_size_t x,
+    bhm_cortex_size_t y,
+    bhm_neuron_t* neuron
+);
+
+// ##########################################
+// ##########################################
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -136,10 +136,12 @@ void c2d_to_file(bhm_cortex2d_t* cortex, char* file_name) {
     fwrite(&(cortex->sample_window), sizeof(bhm_ticks_count_t), 1, out_file);
     fwrite(&(cortex->pulse_mapping), sizeof(bhm_pulse_mapping_t), 1, out_file);
 
-    // Write all neurons.
+    // Write all neurons, always as whole neurons row by row regardless of the storage mode and layout.
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
-            fwrite(&(cortex->neurons[IDX2D(x, y, cortex->width)]), sizeof(bhm_neuron_t), 1, out_file);
+            bhm_neuron_t neuron;
+            c2d_get_neuron(cortex, x, y, &neuron);
+            fwrite(&neuron, sizeof(bhm_neuron_t), 1, out_file);
         }
     }
 
@@ -174,8 +176,23 @@ void c2d_from_file(bhm_cortex2d_t* cortex, char* file_name) {
     fread(&(cortex->sample_window), sizeof(bhm_ticks_count_t), 1, in_file);
     fread(&(cortex->pulse_mapping), sizeof(bhm_pulse_mapping_t), 1, in_file);
 
-    // Read all neurons.
-    cortex->neurons = (bhm_neuron_t*) malloc(cortex->width * cortex->height * sizeof(bhm_neuron_t));
+    // Read all neurons, which are always written row by row.
+    cortex->storage_mode = BHM_STORAGE_MODE_AOS;
+    cortex->layout = BHM_LAYOUT_ROW_MAJOR;
+    cortex->tick_mode = BHM_DEFAULT_TICK_MODE;
+    cortex->rand_mode = BHM_DEFAULT_RAND_MODE;
+    cortex->integration_mode = BHM_DEFAULT_INTEGRATION_MODE;
+    cortex->boundary_mode = BHM_DEFAULT_BOUNDARY_MODE;
+    cortex->tile_width = BHM_DEFAULT_TILE_WIDTH;
+    cortex->tile_height = BHM_DEFAULT_TILE_HEIGHT;
+    cortex->numa_policy = BHM_DEFAULT_NUMA_POLICY;
+    cortex->page_mode = BHM_DEFAULT_PAGE_MODE;
+    cortex->soa = (bhm_neurons_soa_t) {0};
+    cortex->fired = (bhm_fired_bitmap_t) {0};
+    fired_alloc(&(cortex->fired), cortex->width, cortex->height, cortex->nh_radius);
+    cortex->events = (bhm_tile_events_t) {0};
+    events_alloc(&(cortex->events), cortex->width, cortex->height);
+    storage_alloc((void**) &(cortex->neurons), cortex->width * cortex->height * sizeof(bhm_neuron_t), cortex->page_mode, &(cortex->page_size));
     for (bhm_cortex_size_t y = 0; y < cortex->height; y++) {
         for (bhm_cortex_size_t x = 0; x < cortex->width; x++) {
             fread(&(cortex->neurons[IDX2D(x, y, cortex->width)]), sizeof(bhm_neuron_t), 1, in_file);
@@ -197,8 +214,17 @@ bhm_error_code_t c2d_touch_from_map(bhm_cortex2d_t* cortex, char* map_file_name)
     // Make sure sizes are correct.
     if (cortex->width == pgm_content.width && cortex->height == pgm_content.height) {
         for (bhm_cortex_size_t i = 0; i < cortex->width * cortex->height; i++) {
-            cortex->neurons[i].max_syn_count = fmap(pgm_content.data[i], 0, pgm_content.max_value, 0, cortex->max_syn_count);
+            bhm_syn_count_t max_syn_count = fmap(pgm_content.data[i], 0, pgm_content.max_value, 0, cortex->max_syn_count);
+            // Maps are read row by row, regardless of the cortex' layout.
+            bhm_cortex_size_t neuron_index = c2d_neuron_index(cortex, i % cortex->width, i / cortex->width);
+            if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                cortex->soa.max_syn_count[neuron_index] = max_syn_count;
+            } else {
+                cortex->neurons[neuron_index].max_syn_count = max_syn_count;
+            }
         }
+
+        events_invalidate(&(cortex->events));
     } else {
         printf("\nc2d_touch_from_map file sizes do not match with cortex\n");
         return BHM_ERROR_FILE_SIZE_WRONG;
@@ -219,8 +245,17 @@ bhm_error_code_t c2d_inhexc_from_map(bhm_cortex2d_t* cortex, char* map_file_name
     // Make sure sizes are correct.
     if (cortex->width == pgm_content.width && cortex->height == pgm_content.height) {
         for (bhm_cortex_size_t i = 0; i < cortex->width * cortex->height; i++) {
-            cortex->neurons[i].inhexc_ratio = fmap(pgm_content.data[i], 0, pgm_content.max_value, 0, cortex->inhexc_range);
+            bhm_chance_t inhexc_ratio = fmap(pgm_content.data[i], 0, pgm_content.max_value, 0, cortex->inhexc_range);
+            // Maps are read row by row, regardless of the cortex' layout.
+            bhm_cortex_size_t neuron_index = c2d_neuron_index(cortex, i % cortex->width, i / cortex->width);
+            if (cortex->storage_mode == BHM_STORAGE_MODE_SOA) {
+                cortex->soa.inhexc_ratio[neuron_index] = inhexc_ratio;
+            } else {
+                cortex->neurons[neuron_index].inhexc_ratio = inhexc_ratio;
+            }
         }
+
+        events_invalidate(&(cortex->events));
     } else {
         printf("\nc2d_inhexc_from_map file sizes do not match with cortex\n");
         return BHM_ERROR_FILE_SIZE_WRONG;
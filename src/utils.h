@@ -59,6 +59,7 @@ uint64_t nanos();
 
 /// Dumps the cortex' content to a file.
 /// The file is created if not already present, overwritten otherwise.
+/// Synapse masks are written as wide as bhm_nh_mask_t, so files are only readable by builds sharing the same BHM_WIDE_NH setting.
 /// @param cortex The cortex to be written to file.
 /// @param file_name The destination file to write the cortex to.
 void c2d_to_file(bhm_cortex2d_t* cortex, char* file_name);